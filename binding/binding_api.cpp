@@ -1,9 +1,16 @@
-#include "interface_s.hpp"
-#include "interface_d.hpp"
 #include "json_serializer.hpp"
-#include <iostream>
+#include "pipeline.hpp"
+#include "cache_resultados.hpp"
+#include "binario.hpp"
+#include "sesion.hpp"
+#include "paralelo.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
 #include <string>
-#include <cmath>
+#include <string_view>
+#include <vector>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
@@ -11,135 +18,578 @@
 #define EMSCRIPTEN_KEEPALIVE
 #endif
 
+// Hilos de trabajo para las llamadas siguientes (0 = todos los núcleos)
+static std::atomic<int> hilos_configurados { 1 };
+
+// Salidas de solve_process memorizadas (solo entradas con semilla). Se crea
+// en el primer uso para no sumar trabajo al arranque del módulo.
+static GradeSolver::CacheResultados& cache_resultados() {
+    static GradeSolver::CacheResultados cache;
+    return cache;
+}
+
+// Sin iostream: std::cerr obliga a inicializar los streams al cargar el
+// módulo y agranda el .wasm
+static void registrar_error(const char* mensaje) {
+    std::fprintf(stderr, "[Binding Error] %s\n", mensaje);
+}
+
+// Mensaje del último solve_binary fallido en este hilo
+static thread_local std::string ultimo_error_binario;
+
+static GradeSolver::OpcionesSolver opciones_binding() {
+    GradeSolver::OpcionesSolver opciones;
+    opciones.hilos = hilos_configurados.load();
+    return opciones;
+}
+
+// Cuerpo de solve_process: la salida o el error ya serializados. Un acierto
+// de la cache devuelve la misma cadena guardada, sin copiarla.
+static std::shared_ptr<const std::string> resolver_json(const char* input_json_raw,
+                                                        const GradeSolver::OpcionesSolver& opciones) {
+    try {
+        if (input_json_raw == nullptr) {
+            nlohmann::json err;
+            err["status"] = "error";
+            err["message"] = "Input JSON is null";
+            return std::make_shared<const std::string>(err.dump());
+        }
+
+        // Parsear entrada JSON
+        auto j_in = nlohmann::json::parse(input_json_raw);
+        auto entrada = GradeSolver::JSON::parse_entrada_completa(j_in);
+
+        // Ejecutar S -> D -> P y convertir a JSON (o tomarlo de la cache)
+        return GradeSolver::resolver_memorizado(entrada, opciones, cache_resultados());
+
+    } catch (const std::exception& e) {
+        nlohmann::json err;
+        err["status"] = "error";
+        err["message"] = e.what();
+        registrar_error(e.what());
+        return std::make_shared<const std::string>(err.dump());
+    }
+}
+
+static std::string error_json(const char* mensaje) {
+    nlohmann::json err;
+    err["status"] = "error";
+    err["message"] = mensaje;
+    return err.dump();
+}
+
+// Cuerpo de solve_batch. La entrada es un arreglo JSON de entradas o NDJSON
+// (una entrada por línea); la salida es siempre un arreglo JSON con un
+// resultado por entrada, en el mismo orden. Un error en una entrada queda en
+// su posición y no detiene las demás.
+static void resolver_lote(std::string& output_buffer, std::string_view texto,
+                          const GradeSolver::OpcionesSolver& opciones) {
+    const auto inicio = texto.find_first_not_of(" \t\r\n");
+    const bool es_arreglo = inicio != std::string_view::npos && texto[inicio] == '[';
+
+    // Arreglo: se parsea entero (si está mal formado falla todo el lote).
+    // NDJSON: cada línea se parsea dentro de su propia entrada.
+    nlohmann::json arreglo;
+    std::vector<std::string_view> lineas;
+    if (es_arreglo) {
+        arreglo = nlohmann::json::parse(texto);
+    } else {
+        size_t desde = 0;
+        while (desde < texto.size()) {
+            size_t hasta = texto.find('\n', desde);
+            if (hasta == std::string_view::npos) hasta = texto.size();
+            auto linea = texto.substr(desde, hasta - desde);
+            if (linea.find_first_not_of(" \t\r") != std::string_view::npos) lineas.push_back(linea);
+            desde = hasta + 1;
+        }
+    }
+    const size_t total = es_arreglo ? arreglo.size() : lineas.size();
+
+    std::vector<std::shared_ptr<const std::string>> resultados(total);
+
+    // El paralelismo va por entrada; dentro de cada una todo es serial
+    GradeSolver::OpcionesSolver por_entrada = opciones;
+    por_entrada.hilos = 1;
+    ejecutar_en_paralelo(total, opciones.hilos, 1, [&](size_t desde, size_t hasta) {
+        for (size_t i = desde; i < hasta; ++i) {
+            try {
+                auto entrada = es_arreglo
+                    ? GradeSolver::JSON::parse_entrada_completa(arreglo[i])
+                    : GradeSolver::JSON::parse_entrada_completa(nlohmann::json::parse(lineas[i]));
+                resultados[i] = GradeSolver::resolver_memorizado(entrada, por_entrada, cache_resultados());
+            } catch (const std::exception& e) {
+                resultados[i] = std::make_shared<const std::string>(error_json(e.what()));
+            }
+        }
+    });
+
+    // Unir las salidas ya serializadas, sin volver a pasar por un DOM
+    size_t largo = 2 + total;
+    for (const auto& r : resultados) largo += r->size();
+    output_buffer.clear();
+    output_buffer.reserve(largo);
+    output_buffer += '[';
+    for (size_t i = 0; i < total; ++i) {
+        if (i > 0) output_buffer += ',';
+        output_buffer += *resultados[i];
+    }
+    output_buffer += ']';
+}
+
+// solve_batch con los errores de todo el lote ya convertidos a JSON
+static void resolver_lote_json(std::string& output_buffer, const char* input_raw,
+                               const GradeSolver::OpcionesSolver& opciones) {
+    try {
+        if (input_raw == nullptr) throw std::runtime_error("Input JSON is null");
+        resolver_lote(output_buffer, input_raw, opciones);
+    } catch (const std::exception& e) {
+        output_buffer = error_json(e.what());
+        registrar_error(e.what());
+    }
+}
+
+static nlohmann::json cohorte_to_json(const std::vector<GradeSolver::JSON::ResultadoEstudiante>& resultados) {
+    nlohmann::json estudiantes = nlohmann::json::array();
+    for (const auto& resultado : resultados) {
+        estudiantes.push_back(GradeSolver::JSON::to_json(resultado));
+    }
+    return nlohmann::json{ {"estudiantes", estudiantes} };
+}
+
 extern "C" {
+    // Configura los hilos usados por la librería nativa. En la build WASM
+    // sin pthreads no tiene efecto: el cálculo sigue siendo serial.
+    EMSCRIPTEN_KEEPALIVE
+    void solver_configurar_hilos(int hilos) {
+        hilos_configurados.store(hilos < 0 ? 1 : hilos);
+    }
+
+    // ========== CACHE DE RESULTADOS ==========
+    // solve_process memoriza su salida cuando la entrada trae "P.semilla".
+    // Capacidad en MB (0 = desactivada); por defecto 16 MB.
+    EMSCRIPTEN_KEEPALIVE
+    void solver_configurar_cache(int megabytes) {
+        cache_resultados().configurar_capacidad(static_cast<size_t>(megabytes < 0 ? 0 : megabytes) << 20);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void solver_limpiar_cache() {
+        cache_resultados().limpiar();
+    }
+
+    // Nombres de las estrategias registradas, en el orden de los planes de
+    // solve_binary: ["MINIMUM", "BALANCED", ...]
+    EMSCRIPTEN_KEEPALIVE
+    const char* solver_estrategias() {
+        thread_local std::string output_buffer;
+        nlohmann::json nombres = nlohmann::json::array();
+        for (auto estrategia : estrategias_registradas()) nombres.push_back(nombre_estrategia(estrategia));
+        output_buffer = nombres.dump();
+        return output_buffer.c_str();
+    }
+
+    // {"aciertos", "fallos", "omitidas", "expulsadas", "entradas", "bytes", "capacidad_bytes"}
+    EMSCRIPTEN_KEEPALIVE
+    const char* solver_estadisticas_cache() {
+        thread_local std::string output_buffer;
+        const auto e = cache_resultados().estadisticas();
+        output_buffer = nlohmann::json{
+            {"aciertos", e.aciertos}, {"fallos", e.fallos}, {"omitidas", e.omitidas},
+            {"expulsadas", e.expulsadas}, {"entradas", e.entradas}, {"bytes", e.bytes},
+            {"capacidad_bytes", e.capacidad_bytes}
+        }.dump();
+        return output_buffer.c_str();
+    }
+
     EMSCRIPTEN_KEEPALIVE
     const char* solve_process(const char* input_json_raw) {
-        static std::string output_buffer;
-        output_buffer.clear();
+        thread_local std::string output_buffer;
+        output_buffer = *resolver_json(input_json_raw, opciones_binding());
+        return output_buffer.c_str();
+    }
+
+    // ========== LOTES ==========
+    // Muchas entradas independientes en una sola llamada: un arreglo JSON de
+    // entradas de solve_process o NDJSON. Devuelve un arreglo JSON con la
+    // salida de cada una (o su error) en el mismo orden. Las entradas se
+    // reparten entre los hilos configurados y pasan por la cache.
+    EMSCRIPTEN_KEEPALIVE
+    const char* solve_batch(const char* input_raw) {
+        thread_local std::string output_buffer;
+        resolver_lote_json(output_buffer, input_raw, opciones_binding());
+        return output_buffer.c_str();
+    }
+
+    // ========== API REENTRANTE ==========
+    // Las funciones que devuelven `const char*` escriben en un buffer propio
+    // de cada hilo, válido hasta la siguiente llamada a la misma función
+    // desde el mismo hilo. Estas variantes no comparten nada entre llamadas:
+    // el resultado es de quien llama, así que se pueden usar desde muchos
+    // hilos a la vez y guardar los resultados el tiempo que haga falta.
+
+    struct ResultadoBinding {
+        std::shared_ptr<const std::string> datos;
+    };
+
+    // Resultado de solve_process como handle; nunca nulo. Leer con
+    // resultado_datos/resultado_largo y liberar con resultado_liberar.
+    EMSCRIPTEN_KEEPALIVE
+    void* solve_process_r(const char* input_json_raw) {
+        return new ResultadoBinding { resolver_json(input_json_raw, opciones_binding()) };
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void* solve_batch_r(const char* input_raw) {
+        std::string salida;
+        resolver_lote_json(salida, input_raw, opciones_binding());
+        return new ResultadoBinding { std::make_shared<const std::string>(std::move(salida)) };
+    }
+
+    // JSON terminado en '\0'
+    EMSCRIPTEN_KEEPALIVE
+    const char* resultado_datos(const void* resultado) {
+        return resultado == nullptr ? "" : static_cast<const ResultadoBinding*>(resultado)->datos->c_str();
+    }
+
+    // Largo en bytes, sin el '\0'
+    EMSCRIPTEN_KEEPALIVE
+    size_t resultado_largo(const void* resultado) {
+        return resultado == nullptr ? 0 : static_cast<const ResultadoBinding*>(resultado)->datos->size();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void resultado_liberar(void* resultado) {
+        delete static_cast<ResultadoBinding*>(resultado);
+    }
+
+    // solve_process sobre un buffer de quien llama. Escribe el JSON con su
+    // '\0' y devuelve 1 si cabe en `capacidad` bytes; si no, no escribe nada
+    // y devuelve 0. En ambos casos `*largo` queda con el largo sin el '\0'.
+    // Reintentar con un buffer mayor vuelve a resolver (con semilla sale de
+    // la cache y da lo mismo; sin semilla es otra muestra): si el tamaño no
+    // se conoce de antemano conviene solve_process_r.
+    EMSCRIPTEN_KEEPALIVE
+    int solve_process_en(const char* input_json_raw, char* buffer, size_t capacidad, size_t* largo) {
+        const auto salida = resolver_json(input_json_raw, opciones_binding());
+        if (largo != nullptr) *largo = salida->size();
+        if (buffer == nullptr || salida->size() + 1 > capacidad) return 0;
+        std::memcpy(buffer, salida->c_str(), salida->size() + 1);
+        return 1;
+    }
+
+    // ========== SOLVER REUTILIZABLE ==========
+    // Handle con su propio buffer de salida y su cantidad de hilos, para que
+    // quien llama muchas veces no dependa de la configuración global ni del
+    // buffer estático de solve_process. Comparte la cache de resultados.
+
+    struct SolverBinding {
+        int hilos;
+        std::string output_buffer;
+    };
+
+    EMSCRIPTEN_KEEPALIVE
+    void* solver_crear(int hilos) {
+        return new SolverBinding { hilos < 0 ? 1 : hilos, {} };
+    }
 
+    // Igual que solve_process; el resultado vive hasta la próxima llamada
+    // con el mismo handle
+    EMSCRIPTEN_KEEPALIVE
+    const char* solver_resolver(void* handle, const char* input_json_raw) {
+        if (handle == nullptr) return "{\"status\":\"error\",\"message\":\"Solver invalido\"}";
+        auto* binding = static_cast<SolverBinding*>(handle);
+
+        GradeSolver::OpcionesSolver opciones;
+        opciones.hilos = binding->hilos;
+        binding->output_buffer = *resolver_json(input_json_raw, opciones);
+        return binding->output_buffer.c_str();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void solver_destruir(void* handle) {
+        delete static_cast<SolverBinding*>(handle);
+    }
+
+    // ========== RESOLUCIÓN POR TRAMOS ==========
+    // La Máquina P avanza un tramo por llamada, así quien llama puede mostrar
+    // estimaciones parciales y ceder el hilo (el del navegador) entre tramos.
+    // Cancelar es dejar de avanzar y destruir el handle.
+
+    struct TramosBinding {
+        std::unique_ptr<GradeSolver::ResolucionPorTramos> resolucion;  // null si falló
+        std::string error;
+        std::string output_buffer;
+    };
+
+    // Siempre devuelve un handle; si la entrada es inválida el error sale en
+    // solve_avanzar (-1) y solve_resultado
+    EMSCRIPTEN_KEEPALIVE
+    void* solve_iniciar(const char* input_json_raw, int simulaciones_por_tramo) {
+        auto* binding = new TramosBinding {};
         try {
-            if (input_json_raw == nullptr) {
-                nlohmann::json err;
-                err["status"] = "error";
-                err["message"] = "Input JSON is null";
-                output_buffer = err.dump();
-                return output_buffer.c_str();
-            }
+            if (input_json_raw == nullptr) throw std::runtime_error("Input JSON is null");
+            auto entrada = GradeSolver::JSON::parse_entrada_completa(nlohmann::json::parse(input_json_raw));
+            binding->resolucion = std::make_unique<GradeSolver::ResolucionPorTramos>(
+                std::move(entrada), simulaciones_por_tramo, opciones_binding());
+        } catch (const std::exception& e) {
+            binding->error = e.what();
+        }
+        return binding;
+    }
 
-            // Parsear entrada JSON
-            std::string input_json(input_json_raw);
-            auto j_in = nlohmann::json::parse(input_json);
-
-            auto entrada = GradeSolver::JSON::parse_entrada_completa(j_in);
-
-            // Extraer configuración
-            Contexto contexto = entrada.contexto;
-            std::vector<Evaluacion> evaluaciones = entrada.evaluaciones;
-            std::vector<Restriccion> restricciones = entrada.restricciones;
-            int simulaciones = entrada.simulaciones.value_or(10000);
-
-            // Crear las máquinas
-            MaquinaS maquina_s { contexto };
-            MaquinaD maquina_d { contexto };
-            MaquinaP maquina_p { contexto };
-
-            // ========== MAQUINA S: Calcular Espacio de Soluciones ==========
-            auto espacio = maquina_s.calcular_espacio(evaluaciones, restricciones);
-
-            // Si no es posible, devolver resultado con error
-            if (!espacio.es_posible) {
-                GradeSolver::JSON::SalidaCompleta salida;
-                salida.contexto = contexto;
-                salida.evaluaciones = evaluaciones;
-                salida.restricciones = restricciones;
-                salida.espacio_soluciones = espacio;
-
-                auto j_out = GradeSolver::JSON::to_json(salida);
-                output_buffer = j_out.dump();
-                return output_buffer.c_str();
-            }
+    // 1 = quedan tramos, 0 = terminó, -1 = error
+    EMSCRIPTEN_KEEPALIVE
+    int solve_avanzar(void* handle) {
+        if (handle == nullptr) return -1;
+        auto* binding = static_cast<TramosBinding*>(handle);
+        if (binding->resolucion == nullptr) return -1;
 
-            // ========== MAQUINA D: Generar Planes ==========
-            auto plan_minimum = maquina_d.generar_plan(espacio, evaluaciones, restricciones, TipoEstrategia::MINIMUM);
-            auto plan_balanced = maquina_d.generar_plan(espacio, evaluaciones, restricciones, TipoEstrategia::BALANCED);
-            auto plan_max_weight = maquina_d.generar_plan(espacio, evaluaciones, restricciones, TipoEstrategia::MAX_WEIGHT_FIRST);
-            auto plan_min_weight = maquina_d.generar_plan(espacio, evaluaciones, restricciones, TipoEstrategia::MIN_WEIGHT_FIRST);
-
-            // ========== MAQUINA P: Calcular Perfil y Probabilidades ==========
-            PerfilEstadistico perfil;
-
-            // Si el JSON tiene perfil, usarlo
-            if (entrada.perfil.has_value()) {
-                perfil = entrada.perfil.value();
-            } else {
-                // Calcular perfil basado en notas existentes o valores por defecto
-                std::vector<double> notas_existentes;
-                for (const auto& eval : evaluaciones) {
-                    if (eval.valor_actual.has_value()) {
-                        notas_existentes.push_back(eval.valor_actual.value());
-                    }
-                }
+        try {
+            return binding->resolucion->avanzar() ? 1 : 0;
+        } catch (const std::exception& e) {
+            binding->error = e.what();
+            binding->resolucion.reset();
+            return -1;
+        }
+    }
 
-                if (!notas_existentes.empty()) {
-                    double suma = 0.0;
-                    for (double n : notas_existentes) suma += n;
-                    perfil.media_historica = suma / notas_existentes.size();
-
-                    double suma_cuadrados = 0.0;
-                    for (double n : notas_existentes) {
-                        double diff = n - perfil.media_historica;
-                        suma_cuadrados += diff * diff;
-                    }
-                    perfil.desviacion_estandar = std::sqrt(suma_cuadrados / notas_existentes.size());
-
-                    // Desviación mínima: 10% del rango de notas
-                    double desv_minima = (contexto.nota_maxima - contexto.nota_minima) * 0.10;
-                    if (perfil.desviacion_estandar < desv_minima) {
-                        perfil.desviacion_estandar = desv_minima;
-                    }
-                } else {
-                    perfil.media_historica = contexto.nota_aprobacion + (contexto.nota_maxima - contexto.nota_aprobacion) * 0.2;
-                    perfil.desviacion_estandar = (contexto.nota_maxima - contexto.nota_minima) / 4.0;
-                }
-            }
+    // {"progreso": {simulaciones_usadas, simulaciones_totales, terminado},
+    //  "maquina_p": {...}} con lo simulado hasta ahora
+    EMSCRIPTEN_KEEPALIVE
+    const char* solve_parcial(void* handle) {
+        if (handle == nullptr) return "{\"status\":\"error\",\"message\":\"Resolucion invalida\"}";
+        auto* binding = static_cast<TramosBinding*>(handle);
+        if (binding->resolucion == nullptr) {
+            binding->output_buffer = error_json(binding->error.c_str());
+            return binding->output_buffer.c_str();
+        }
+
+        const auto& resolucion = *binding->resolucion;
+        nlohmann::json j;
+        j["progreso"] = {
+            { "simulaciones_usadas", resolucion.simulaciones_usadas() },
+            { "simulaciones_totales", resolucion.simulaciones_totales() },
+            { "terminado", resolucion.terminado() },
+        };
+        nlohmann::json reportes = nlohmann::json::object();
+        for (const auto& [estrategia, reporte] : resolucion.reportes_parciales()) {
+            reportes[estrategia] = GradeSolver::JSON::to_json(reporte);
+        }
+        j["maquina_p"] = reportes;
+        binding->output_buffer = j.dump();
+        return binding->output_buffer.c_str();
+    }
+
+    // La salida de solve_process, una vez que solve_avanzar devolvió 0
+    EMSCRIPTEN_KEEPALIVE
+    const char* solve_resultado(void* handle) {
+        if (handle == nullptr) return "{\"status\":\"error\",\"message\":\"Resolucion invalida\"}";
+        auto* binding = static_cast<TramosBinding*>(handle);
+
+        try {
+            if (binding->resolucion == nullptr) throw std::runtime_error(binding->error);
+            binding->output_buffer = to_json(binding->resolucion->resultado()).dump();
+        } catch (const std::exception& e) {
+            binding->output_buffer = error_json(e.what());
+        }
+        return binding->output_buffer.c_str();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void solve_destruir(void* handle) {
+        delete static_cast<TramosBinding*>(handle);
+    }
+
+    // ========== COHORTE ==========
+    // Un curso y una matriz de notas por estudiante en una sola llamada. La
+    // definición del curso se parsea y compila una vez para toda la cohorte.
+
+    // Entrada: el JSON de solve_process más "cohorte": [[nota|null, ...], ...]
+    // con una fila por estudiante en el orden de S.evaluaciones.
+    // Salida: {"estudiantes": [{maquina_s, maquina_d, maquina_p, perfil_usado}, ...]}
+    EMSCRIPTEN_KEEPALIVE
+    const char* solve_cohort(const char* input_json_raw) {
+        thread_local std::string output_buffer;
+
+        try {
+            if (input_json_raw == nullptr) throw std::runtime_error("Input JSON is null");
+
+            auto entrada = GradeSolver::JSON::parse_entrada_cohorte(nlohmann::json::parse(input_json_raw));
+            output_buffer = cohorte_to_json(GradeSolver::resolver_cohorte(entrada, opciones_binding())).dump();
 
-            // Analizar probabilidades para cada plan
-            auto reporte_minimum = maquina_p.analizar(espacio, plan_minimum, evaluaciones, restricciones, perfil, simulaciones);
-            auto reporte_balanced = maquina_p.analizar(espacio, plan_balanced, evaluaciones, restricciones, perfil, simulaciones);
-            auto reporte_max_weight = maquina_p.analizar(espacio, plan_max_weight, evaluaciones, restricciones, perfil, simulaciones);
-            auto reporte_min_weight = maquina_p.analizar(espacio, plan_min_weight, evaluaciones, restricciones, perfil, simulaciones);
+        } catch (const std::exception& e) {
+            nlohmann::json err;
+            err["status"] = "error";
+            err["message"] = e.what();
+            output_buffer = err.dump();
+            registrar_error(e.what());
+        }
 
-            // ========== CONSTRUIR SALIDA ==========
-            GradeSolver::JSON::SalidaCompleta salida;
-            salida.contexto = contexto;
-            salida.evaluaciones = evaluaciones;
-            salida.restricciones = restricciones;
-            salida.espacio_soluciones = espacio;
+        return output_buffer.c_str();
+    }
 
-            salida.planes["MINIMUM"] = plan_minimum;
-            salida.planes["BALANCED"] = plan_balanced;
-            salida.planes["MAX_WEIGHT_FIRST"] = plan_max_weight;
-            salida.planes["MIN_WEIGHT_FIRST"] = plan_min_weight;
+    // Variante sin JSON para las notas: `notas` es una matriz fila-mayor de
+    // estudiantes x evaluaciones (NaN = pendiente). Las notas de
+    // S.evaluaciones en `curso_json` se ignoran.
+    EMSCRIPTEN_KEEPALIVE
+    const char* solve_cohort_matrix(const char* curso_json_raw, const double* notas,
+                                    int estudiantes, int evaluaciones) {
+        thread_local std::string output_buffer;
 
-            salida.reportes_probabilidad["MINIMUM"] = reporte_minimum;
-            salida.reportes_probabilidad["BALANCED"] = reporte_balanced;
-            salida.reportes_probabilidad["MAX_WEIGHT_FIRST"] = reporte_max_weight;
-            salida.reportes_probabilidad["MIN_WEIGHT_FIRST"] = reporte_min_weight;
+        try {
+            if (curso_json_raw == nullptr) throw std::runtime_error("Input JSON is null");
+            if (estudiantes < 0 || (estudiantes > 0 && notas == nullptr)) {
+                throw std::runtime_error("Matriz de notas invalida");
+            }
 
-            salida.perfil_usado = perfil;
+            GradeSolver::JSON::EntradaCohorte entrada;
+            entrada.curso = GradeSolver::JSON::parse_entrada_completa(nlohmann::json::parse(curso_json_raw));
+            if (static_cast<size_t>(evaluaciones) != entrada.curso.evaluaciones.size()) {
+                throw std::runtime_error("La matriz debe tener " +
+                                         std::to_string(entrada.curso.evaluaciones.size()) + " columnas");
+            }
+            entrada.estudiantes = static_cast<size_t>(estudiantes);
+            entrada.notas.assign(notas, notas + static_cast<size_t>(estudiantes) * evaluaciones);
 
-            // Convertir a JSON y devolver
-            auto j_out = GradeSolver::JSON::to_json(salida);
-            output_buffer = j_out.dump();
+            output_buffer = cohorte_to_json(GradeSolver::resolver_cohorte(entrada, opciones_binding())).dump();
 
         } catch (const std::exception& e) {
             nlohmann::json err;
             err["status"] = "error";
             err["message"] = e.what();
             output_buffer = err.dump();
-            std::cerr << "[Binding Error] " << e.what() << std::endl;
+            registrar_error(e.what());
         }
 
         return output_buffer.c_str();
     }
+
+    // ========== ENTRADA/SALIDA BINARIA ==========
+    // Sin JSON: el curso en arreglos planos y el resultado escrito en
+    // `salida` (layout en lib/pipeline/binario.hpp). Devuelve el largo de
+    // salida necesario (si es mayor que `largo_salida` no escribe nada) o -1
+    // si la entrada es inválida, con el mensaje en solve_binary_error().
+    EMSCRIPTEN_KEEPALIVE
+    int solve_binary(const int32_t* enteros, const double* reales, const uint8_t* membresia,
+                     double* salida, int largo_salida) {
+        try {
+            ultimo_error_binario.clear();
+            return static_cast<int>(GradeSolver::resolver_binario(enteros, reales, membresia, salida,
+                                                                  largo_salida < 0 ? 0 : largo_salida,
+                                                                  opciones_binding()));
+        } catch (const std::exception& e) {
+            ultimo_error_binario = e.what();
+            return -1;
+        }
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    const char* solve_binary_error() {
+        return ultimo_error_binario.c_str();
+    }
+
+    // ========== SESIÓN INCREMENTAL ==========
+    // Handle opaco que mantiene el curso compilado entre llamadas. Cada
+    // set_grade/clear_grade solo actualiza agregados; sesion_es_posible y
+    // sesion_rango responden desde esos agregados. sesion_resultado es la
+    // ruta lenta: recalcula lo que haya cambiado y devuelve maquina_s y
+    // maquina_d.
+
+    struct SesionBinding {
+        SesionSolver sesion;
+        std::string output_buffer;
+        double rango[3];
+    };
+
+    EMSCRIPTEN_KEEPALIVE
+    void* sesion_crear(const char* input_json_raw) {
+        try {
+            if (input_json_raw == nullptr) return nullptr;
+            auto entrada = GradeSolver::JSON::parse_entrada_completa(nlohmann::json::parse(input_json_raw));
+            return new SesionBinding { SesionSolver(entrada.contexto, entrada.evaluaciones, entrada.restricciones), {}, {} };
+        } catch (const std::exception& e) {
+            registrar_error(e.what());
+            return nullptr;
+        }
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int sesion_set_grade(void* handle, const char* id, double valor) {
+        if (handle == nullptr || id == nullptr) return 0;
+        try {
+            static_cast<SesionBinding*>(handle)->sesion.set_grade(id, valor);
+            return 1;
+        } catch (const std::exception&) {
+            return 0;
+        }
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int sesion_clear_grade(void* handle, const char* id) {
+        if (handle == nullptr || id == nullptr) return 0;
+        try {
+            static_cast<SesionBinding*>(handle)->sesion.clear_grade(id);
+            return 1;
+        } catch (const std::exception&) {
+            return 0;
+        }
+    }
+
+    // 1 si todavía se puede aprobar, 0 si no, -1 si el handle es nulo
+    EMSCRIPTEN_KEEPALIVE
+    int sesion_es_posible(void* handle) {
+        if (handle == nullptr) return -1;
+        return static_cast<SesionBinding*>(handle)->sesion.es_posible() ? 1 : 0;
+    }
+
+    // Límites de una evaluación pendiente: (min_supervivencia, min_seguridad,
+    // max_posible), válidos hasta la siguiente llamada con el mismo handle.
+    // Nulo si el id no existe o la evaluación ya tiene nota.
+    EMSCRIPTEN_KEEPALIVE
+    const double* sesion_rango(void* handle, const char* id) {
+        if (handle == nullptr || id == nullptr) return nullptr;
+        auto* binding = static_cast<SesionBinding*>(handle);
+        try {
+            const RangoFactible rango = binding->sesion.rango(id);
+            binding->rango[0] = rango.min_supervivencia;
+            binding->rango[1] = rango.min_seguridad;
+            binding->rango[2] = rango.max_posible;
+            return binding->rango;
+        } catch (const std::exception&) {
+            return nullptr;
+        }
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    const char* sesion_resultado(void* handle) {
+        if (handle == nullptr) return "{\"status\":\"error\",\"message\":\"Sesion invalida\"}";
+        auto* binding = static_cast<SesionBinding*>(handle);
+
+        try {
+            nlohmann::json j;
+            const auto& espacio = binding->sesion.espacio();
+            j["maquina_s"] = GradeSolver::JSON::to_json(espacio);
+
+            if (espacio.es_posible) {
+                nlohmann::json planes = nlohmann::json::object();
+                for (auto estrategia : estrategias_registradas()) {
+                    planes[GradeSolver::JSON::tipo_estrategia_to_string(estrategia)] =
+                        GradeSolver::JSON::to_json(binding->sesion.sugerencias(estrategia));
+                }
+                j["maquina_d"] = planes;
+            }
+            binding->output_buffer = j.dump();
+        } catch (const std::exception& e) {
+            nlohmann::json err;
+            err["status"] = "error";
+            err["message"] = e.what();
+            binding->output_buffer = err.dump();
+        }
+        return binding->output_buffer.c_str();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void sesion_destruir(void* handle) {
+        delete static_cast<SesionBinding*>(handle);
+    }
 }
@@ -9,9 +9,184 @@ function defaultLocateFile(path) {
   return new URL(path, import.meta.url).toString();
 }
 
+// Módulos WASM compilados por URL, una compilación por página
+const compilados = new Map();
+
+function compilarWasm(url) {
+  let compilado = compilados.get(url);
+  if (compilado === undefined) {
+    compilado = compilarDesde(url);
+    compilados.set(url, compilado);
+  }
+  return compilado;
+}
+
+// compileStreaming compila mientras descarga y deja al navegador cachear el
+// código compilado junto a la respuesta. Exige `Content-Type:
+// application/wasm`, así que si falla se reintenta con los bytes. null si no
+// se pudo (sin fetch, 404, motor sin soporte): emscripten lo intenta por su cuenta.
+async function compilarDesde(url) {
+  if (typeof fetch !== "function") {
+    return null;
+  }
+  try {
+    if (typeof WebAssembly.compileStreaming === "function") {
+      try {
+        return await WebAssembly.compileStreaming(fetch(url));
+      } catch {
+        // Tipo MIME incorrecto u otro error: se reintenta abajo
+      }
+    }
+    const respuesta = await fetch(url);
+    return respuesta.ok ? await WebAssembly.compile(await respuesta.arrayBuffer()) : null;
+  } catch {
+    return null;
+  }
+}
+
+// Opciones de emscripten para instanciar desde un módulo ya compilado
+function desdeCompilado(modulo) {
+  if (modulo === null) {
+    return {};
+  }
+  return {
+    instantiateWasm(imports, listo) {
+      WebAssembly.instantiate(modulo, imports).then((instancia) => listo(instancia, modulo));
+      return {};
+    },
+  };
+}
+
 export async function createSolverModule(options = {}) {
   const locateFile = options.locateFile ?? defaultLocateFile;
-  return createSolverModuleFactory({ ...options, locateFile });
+  const compilado = options.locateFile === undefined ? desdeCompilado(await compilarWasm(wasmUrl)) : {};
+  return createSolverModuleFactory({ ...compilado, ...options, locateFile });
+}
+
+// Módulo mínimo con una instrucción SIMD128: valida solo si el motor la soporta
+const MODULO_SIMD = new Uint8Array([
+  0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11,
+]);
+
+// Módulo mínimo con una memoria compartida: valida solo si el motor
+// soporta la extensión de hilos (atomics y memoria compartida)
+const MODULO_HILOS = new Uint8Array([0, 97, 115, 109, 1, 0, 0, 0, 5, 4, 1, 3, 1, 1]);
+
+function valida(bytes) {
+  try {
+    return typeof WebAssembly === "object" && WebAssembly.validate(bytes);
+  } catch {
+    return false;
+  }
+}
+
+function soportaSimd() {
+  return valida(MODULO_SIMD);
+}
+
+// pthreads en el navegador requiere aislamiento entre orígenes
+// (Cross-Origin-Opener-Policy: same-origin y Cross-Origin-Embedder-Policy:
+// require-corp); sin eso no hay SharedArrayBuffer
+function soportaHilos() {
+  return (
+    valida(MODULO_HILOS) && typeof SharedArrayBuffer !== "undefined" && globalThis.crossOriginIsolated === true
+  );
+}
+
+// Variantes de la más rápida a la más portable (ver scripts/build_wasm.sh).
+// Si una no viene en el paquete su import falla y se usa la siguiente.
+const VARIANTES = [
+  { nombre: "hilos", script: "./hilos/web/solver.mjs", soportada: () => soportaSimd() && soportaHilos() },
+  { nombre: "simd", script: "./simd/web/solver.mjs", soportada: soportaSimd },
+];
+
+async function instanciar(variante) {
+  if (variante.script === null) {
+    return createSolverModule();
+  }
+  // Cada variante carga su .wasm (y sus workers) desde su propio directorio
+  const script = new URL(variante.script, import.meta.url);
+  const { default: factory } = await import(script.toString());
+  return factory(desdeCompilado(await compilarWasm(new URL("solver.wasm", script).toString())));
+}
+
+// Una sola instancia del módulo para todo el proceso: instanciar WASM y
+// reservar su memoria inicial cuesta mucho más que resolver un curso.
+let apiPromise = null;
+
+function crearApi(moduleInstance, variante) {
+  if (variante === "hilos") {
+    // Tantos hilos como workers creó el módulo (uno por núcleo)
+    moduleInstance.ccall("solver_configurar_hilos", null, ["number"], [0]);
+  }
+  return {
+    module: moduleInstance,
+    variante,
+    // Nombres de las estrategias, en el orden de los planes de solve_binary
+    estrategias: JSON.parse(moduleInstance.ccall("solver_estrategias", "string", [], [])),
+    solveProcess: moduleInstance.cwrap("solve_process", "string", ["string"]),
+    solveCohort: moduleInstance.cwrap("solve_cohort", "string", ["string"]),
+    solveBatch: moduleInstance.cwrap("solve_batch", "string", ["string"]),
+    solverCrear: moduleInstance.cwrap("solver_crear", "number", ["number"]),
+    solverResolver: moduleInstance.cwrap("solver_resolver", "string", ["number", "string"]),
+    solverDestruir: moduleInstance.cwrap("solver_destruir", null, ["number"]),
+    solveIniciar: moduleInstance.cwrap("solve_iniciar", "number", ["string", "number"]),
+    solveAvanzar: moduleInstance.cwrap("solve_avanzar", "number", ["number"]),
+    solveParcial: moduleInstance.cwrap("solve_parcial", "string", ["number"]),
+    solveResultado: moduleInstance.cwrap("solve_resultado", "string", ["number"]),
+    solveDestruir: moduleInstance.cwrap("solve_destruir", null, ["number"]),
+  };
+}
+
+/**
+ * Devuelve el módulo compartido, instanciándolo en la primera llamada.
+ * Si la instanciación falla, la siguiente llamada lo reintenta.
+ * @returns {Promise<object>}
+ */
+function getApi() {
+  if (apiPromise === null) {
+    apiPromise = cargarApi().catch((error) => {
+      apiPromise = null;
+      throw error;
+    });
+  }
+  return apiPromise;
+}
+
+// Prueba las variantes soportadas en orden; si una no está o falla al
+// instanciarse cae a la siguiente, y al final a la base
+async function cargarApi() {
+  const candidatas = [...VARIANTES.filter((variante) => variante.soportada()), { nombre: "base", script: null }];
+  let ultimoError;
+  for (const variante of candidatas) {
+    try {
+      return crearApi(await instanciar(variante), variante.nombre);
+    } catch (error) {
+      ultimoError = error;
+    }
+  }
+  throw ultimoError;
+}
+
+/**
+ * Variante del módulo WASM en uso: "hilos", "simd" o "base".
+ * @returns {Promise<string>}
+ */
+export async function wasmVariant() {
+  return (await getApi()).variante;
+}
+
+/**
+ * Instancia el módulo compartido sin resolver nada, para no pagar la
+ * carga en la primera llamada.
+ * @returns {Promise<void>}
+ */
+export async function ready() {
+  await getApi();
+}
+
+function toJson(input) {
+  return typeof input === "string" ? input : JSON.stringify(input);
 }
 
 /**
@@ -20,15 +195,353 @@ export async function createSolverModule(options = {}) {
  * @returns {Promise<object>}
  */
 export async function solve(input) {
-  const moduleInstance = await createSolverModule();
-  const inputJson = typeof input === "string" ? input : JSON.stringify(input);
-  const outputJson = moduleInstance.ccall(
-    "solve_process",
-    "string",
-    ["string"],
-    [inputJson]
-  );
-  return JSON.parse(outputJson);
+  const api = await getApi();
+  return JSON.parse(api.solveProcess(toJson(input)));
+}
+
+/**
+ * Resuelve un mismo curso para toda una cohorte en una sola llamada.
+ * La entrada es la de `solve` más `cohorte`: una fila de notas (o null)
+ * por estudiante, en el orden de `S.evaluaciones`.
+ * @param {object|string} input
+ * @returns {Promise<object>}
+ */
+export async function solveCohort(input) {
+  const api = await getApi();
+  return JSON.parse(api.solveCohort(toJson(input)));
+}
+
+/**
+ * Resuelve muchas entradas independientes cruzando a WASM una sola vez.
+ * Acepta un arreglo (de objetos o de JSON strings) o un string con un
+ * arreglo JSON o NDJSON. Devuelve un resultado por entrada, en el mismo
+ * orden; una entrada inválida deja su error en su posición sin detener el
+ * resto.
+ * @param {Array<object|string>|string} inputs
+ * @returns {Promise<object[]>}
+ */
+export async function solveBatch(inputs) {
+  const api = await getApi();
+  let texto;
+  if (typeof inputs === "string") {
+    texto = inputs;
+  } else if (inputs.every((input) => typeof input === "string")) {
+    texto = "[" + inputs.join(",") + "]";
+  } else {
+    texto = JSON.stringify(inputs.map((input) => (typeof input === "string" ? JSON.parse(input) : input)));
+  }
+  const salida = JSON.parse(api.solveBatch(texto));
+  if (!Array.isArray(salida)) {
+    throw new Error(salida.message);
+  }
+  return salida;
+}
+
+/**
+ * Crea un solver reutilizable con su propio buffer de salida. Sus llamadas
+ * son síncronas: el costo es solo el de resolver. Llamar a `dispose()` al
+ * terminar.
+ * @param {{hilos?: number}} [options]
+ * @returns {Promise<object>}
+ */
+export async function createSolver(options = {}) {
+  const api = await getApi();
+  let handle = api.solverCrear(options.hilos ?? 1);
+  if (handle === 0) {
+    throw new Error("No se pudo crear el solver");
+  }
+
+  return {
+    solve(input) {
+      if (handle === 0) {
+        throw new Error("El solver ya fue liberado");
+      }
+      return JSON.parse(api.solverResolver(handle, toJson(input)));
+    },
+    dispose() {
+      if (handle !== 0) {
+        api.solverDestruir(handle);
+        handle = 0;
+      }
+    },
+  };
+}
+
+// Escenarios por tramo de `solveProgressive` si no se indica otro
+const TRAMO_POR_DEFECTO = 4096;
+
+// Cede el hilo al event loop entre tramos. setTimeout anidado se atrasa
+// ~4 ms en los navegadores, así que se prefiere setImmediate o un MessageChannel.
+function ceder() {
+  if (typeof setImmediate === "function") {
+    return new Promise((resolve) => setImmediate(resolve));
+  }
+  if (typeof MessageChannel === "function") {
+    return new Promise((resolve) => {
+      const canal = new MessageChannel();
+      canal.port1.onmessage = () => {
+        canal.port1.close();
+        resolve();
+      };
+      canal.port2.postMessage(null);
+    });
+  }
+  return new Promise((resolve) => setTimeout(resolve, 0));
+}
+
+function verificarSenal(signal) {
+  if (signal?.aborted) {
+    throw signal.reason ?? new DOMException("La resolucion fue abortada", "AbortError");
+  }
+}
+
+/**
+ * Resuelve de a tramos de la Máquina P para mostrar estimaciones tempranas
+ * sin congelar la página: entre tramos cede el hilo al event loop. Cada
+ * valor es `{progreso, maquina_p}` con las probabilidades estimadas hasta
+ * ahí; el último trae además `resultado`, la misma salida de `solve`.
+ * Abortar `signal` (o salir del `for await` con `break`) detiene la
+ * simulación y libera su memoria; abortar rechaza con `signal.reason`.
+ * @param {object|string} input
+ * @param {{signal?: AbortSignal, simulacionesPorTramo?: number}} [options]
+ * @returns {AsyncGenerator<object>}
+ */
+export async function* solveProgressive(input, options = {}) {
+  const { signal, simulacionesPorTramo = TRAMO_POR_DEFECTO } = options;
+  verificarSenal(signal);
+  const api = await getApi();
+  verificarSenal(signal);
+
+  const handle = api.solveIniciar(toJson(input), simulacionesPorTramo);
+  try {
+    while (true) {
+      const estado = api.solveAvanzar(handle);
+      if (estado === -1) {
+        throw new Error(JSON.parse(api.solveResultado(handle)).message);
+      }
+
+      const parcial = JSON.parse(api.solveParcial(handle));
+      if (estado === 0) {
+        parcial.resultado = JSON.parse(api.solveResultado(handle));
+        yield parcial;
+        return;
+      }
+      yield parcial;
+
+      await ceder();
+      verificarSenal(signal);
+    }
+  } finally {
+    api.solveDestruir(handle);
+  }
+}
+
+// Layout de solve_binary (lib/pipeline/binario.hpp)
+const CABECERA_ENTEROS = 8;
+const CABECERA_REALES = 5;
+const CABECERA_PLAN = 4;
+const MUESTREOS = { MC: 0, QMC: 1, IS: 2 };
+const TIPOS_RESTRICCION = { PROMEDIO_SIMPLE_TAG: 0, NOTA_MINIMA_INDIVIDUAL_TAG: 1 };
+
+/**
+ * Crea un solver binario: el curso se escribe directo en vistas tipadas
+ * sobre la memoria WASM y el resultado se lee de otras vistas, sin JSON ni
+ * copias. Las vistas se recrean si la memoria WASM crece, así que hay que
+ * volver a leer las propiedades después de cada `solve`.
+ * @param {{evaluaciones: number, tags: number, restricciones: number}} dimensiones
+ * @returns {Promise<object>}
+ */
+export async function createBinarySolver({ evaluaciones, tags, restricciones }) {
+  const { module: moduleInstance, estrategias } = await getApi();
+  const n = evaluaciones;
+  const t = tags;
+  const r = restricciones;
+
+  const largoEnteros = CABECERA_ENTEROS + 2 * r;
+  const largoReales = CABECERA_REALES + 2 * n + r;
+  const largoSalida = 1 + 3 * n + r + estrategias.length * (CABECERA_PLAN + n);
+
+  let pEnteros = moduleInstance._malloc(largoEnteros * 4);
+  const pReales = moduleInstance._malloc(largoReales * 8);
+  const pMembresia = moduleInstance._malloc(Math.max(1, n * t));
+  const pSalida = moduleInstance._malloc(largoSalida * 8);
+
+  let buffer = null;
+  let vistas = null;
+  function obtenerVistas() {
+    if (pEnteros === 0) {
+      throw new Error("El solver ya fue liberado");
+    }
+    if (buffer !== moduleInstance.HEAPF64.buffer) {
+      buffer = moduleInstance.HEAPF64.buffer;
+      const enteros = new Int32Array(buffer, pEnteros, largoEnteros);
+      const reales = new Float64Array(buffer, pReales, largoReales);
+      vistas = {
+        enteros,
+        contexto: reales.subarray(0, 3),
+        perfil: reales.subarray(3, CABECERA_REALES),
+        pesos: reales.subarray(CABECERA_REALES, CABECERA_REALES + n),
+        notas: reales.subarray(CABECERA_REALES + n, CABECERA_REALES + 2 * n),
+        minimos: reales.subarray(CABECERA_REALES + 2 * n),
+        restricciones: enteros.subarray(CABECERA_ENTEROS),
+        membresia: new Uint8Array(buffer, pMembresia, n * t),
+        salida: new Float64Array(buffer, pSalida, largoSalida),
+      };
+    }
+    return vistas;
+  }
+
+  function leerSalida(salida) {
+    const inicioPlanes = 1 + 3 * n + r;
+    const porPlan = CABECERA_PLAN + n;
+    return {
+      es_posible: salida[0] === 1,
+      rangos: salida.subarray(1, 1 + 3 * n),
+      incumplibles: salida.subarray(1 + 3 * n, inicioPlanes),
+      planes: estrategias.map((estrategia, p) => {
+        const bloque = salida.subarray(inicioPlanes + p * porPlan, inicioPlanes + (p + 1) * porPlan);
+        return {
+          estrategia,
+          promedio_final_teorico: bloque[0],
+          probabilidad_general: bloque[1],
+          probabilidad_del_plan: bloque[2],
+          viabilidad: bloque[3],
+          notas: bloque.subarray(CABECERA_PLAN),
+        };
+      }),
+    };
+  }
+
+  return {
+    get contexto() { return obtenerVistas().contexto; },
+    get perfil() { return obtenerVistas().perfil; },
+    get pesos() { return obtenerVistas().pesos; },
+    get notas() { return obtenerVistas().notas; },
+    get minimos() { return obtenerVistas().minimos; },
+    get restricciones() { return obtenerVistas().restricciones; },
+    get membresia() { return obtenerVistas().membresia; },
+
+    /** Fija la restricción k como (tipo, tag). */
+    setRestriccion(k, tipo, tag) {
+      const codigo = typeof tipo === "string" ? TIPOS_RESTRICCION[tipo] : tipo;
+      const v = obtenerVistas().restricciones;
+      v[2 * k] = codigo;
+      v[2 * k + 1] = tag;
+    },
+
+    solve(options = {}) {
+      const { enteros } = obtenerVistas();
+      enteros[0] = n;
+      enteros[1] = t;
+      enteros[2] = r;
+      enteros[3] = options.simulaciones ?? 0;
+      enteros[4] = MUESTREOS[options.muestreo ?? "MC"];
+      enteros[5] = (options.semilla !== undefined ? 1 : 0) | (options.usarPerfil ? 2 : 0);
+      const semilla = BigInt(options.semilla ?? 0);
+      enteros[6] = Number(BigInt.asIntN(32, semilla));
+      enteros[7] = Number(BigInt.asIntN(32, semilla >> 32n));
+
+      const escritos = moduleInstance._solve_binary(pEnteros, pReales, pMembresia, pSalida, largoSalida);
+      if (escritos < 0) {
+        throw new Error(moduleInstance.UTF8ToString(moduleInstance._solve_binary_error()));
+      }
+      return leerSalida(obtenerVistas().salida);
+    },
+
+    dispose() {
+      if (pEnteros !== 0) {
+        moduleInstance._free(pEnteros);
+        moduleInstance._free(pReales);
+        moduleInstance._free(pMembresia);
+        moduleInstance._free(pSalida);
+        pEnteros = 0;
+      }
+    },
+  };
+}
+
+/**
+ * Crea una sesión incremental: mantiene el curso en memoria WASM y permite
+ * actualizar notas una a una sin recalcular todo el pipeline. `rango` e
+ * `isPossible` responden desde los agregados de la sesión; `result()` es la
+ * ruta lenta (recalcula el espacio y los planes). Llamar a `dispose()` al
+ * terminar.
+ * @param {object|string} input
+ * @returns {Promise<object>}
+ */
+export async function createSession(input) {
+  const { module: moduleInstance } = await getApi();
+  const inputJson = toJson(input);
+  let handle = moduleInstance.ccall("sesion_crear", "number", ["string"], [inputJson]);
+  if (handle === 0) {
+    throw new Error("No se pudo crear la sesion");
+  }
+
+  function vigente() {
+    if (handle === 0) {
+      throw new Error("La sesion ya fue liberada");
+    }
+    return handle;
+  }
+
+  return {
+    setGrade(id, value) {
+      return moduleInstance.ccall("sesion_set_grade", "number", ["number", "string", "number"], [vigente(), id, value]) === 1;
+    },
+    clearGrade(id) {
+      return moduleInstance.ccall("sesion_clear_grade", "number", ["number", "string"], [vigente(), id]) === 1;
+    },
+    isPossible() {
+      return moduleInstance.ccall("sesion_es_posible", "number", ["number"], [vigente()]) === 1;
+    },
+    rango(id) {
+      const puntero = moduleInstance.ccall("sesion_rango", "number", ["number", "string"], [vigente(), id]);
+      if (puntero === 0) {
+        return null;
+      }
+      // HEAPF64 se lee después de la llamada: la memoria pudo haber crecido
+      const i = puntero >> 3;
+      const heap = moduleInstance.HEAPF64;
+      return { min_supervivencia: heap[i], min_seguridad: heap[i + 1], max_posible: heap[i + 2] };
+    },
+    result() {
+      return JSON.parse(moduleInstance.ccall("sesion_resultado", "string", ["number"], [vigente()]));
+    },
+    dispose() {
+      if (handle !== 0) {
+        moduleInstance.ccall("sesion_destruir", null, ["number"], [handle]);
+        handle = 0;
+      }
+    },
+  };
+}
+
+/**
+ * Estadísticas de la cache de resultados de `solve` (solo entradas con semilla).
+ * @returns {Promise<object>}
+ */
+export async function cacheStats() {
+  const { module: moduleInstance } = await getApi();
+  return JSON.parse(moduleInstance.ccall("solver_estadisticas_cache", "string", [], []));
+}
+
+/**
+ * Fija la capacidad de la cache de resultados en MB (0 la desactiva).
+ * @param {number} megabytes
+ * @returns {Promise<void>}
+ */
+export async function configureCache(megabytes) {
+  const { module: moduleInstance } = await getApi();
+  moduleInstance.ccall("solver_configurar_cache", null, ["number"], [megabytes]);
+}
+
+/**
+ * Vacía la cache de resultados.
+ * @returns {Promise<void>}
+ */
+export async function clearCache() {
+  const { module: moduleInstance } = await getApi();
+  moduleInstance.ccall("solver_limpiar_cache", null, [], []);
 }
 
 export default solve;
@@ -0,0 +1,207 @@
+"use strict";
+
+const os = require("os");
+const path = require("path");
+const { Worker } = require("worker_threads");
+
+// Latencias recientes que se guardan para los percentiles de `stats()`
+const MUESTRAS_LATENCIA = 1024;
+
+function percentil(ordenadas, p) {
+  if (ordenadas.length === 0) {
+    return 0;
+  }
+  const k = Math.min(ordenadas.length - 1, Math.floor(p * ordenadas.length));
+  return ordenadas[k];
+}
+
+/**
+ * Pool de workers de Node, cada uno con su propia instancia WASM ya
+ * cargada. `solve` y `solveBatch` se encolan y se reparten entre los
+ * workers libres sin bloquear el hilo que llama. Con la cola llena las
+ * llamadas se rechazan de inmediato (error con `code`
+ * "GRADESOLVER_POOL_LLENO") en vez de acumular memoria.
+ *
+ * Dentro de los workers se usa la variante "simd" (o la base): la variante
+ * con hilos repartiría cada solve entre todos los núcleos, que el pool ya
+ * ocupa. `GRADESOLVER_WASM` la reemplaza.
+ *
+ * @param {{size?: number, maxQueue?: number}} [options]
+ * @returns {object}
+ */
+function createPool(options = {}) {
+  const nucleos = typeof os.availableParallelism === "function" ? os.availableParallelism() : os.cpus().length;
+  const size = Math.max(1, options.size ?? nucleos);
+  const maxQueue = Math.max(0, options.maxQueue ?? size * 64);
+
+  const env = { ...process.env, GRADESOLVER_WASM: process.env.GRADESOLVER_WASM ?? "simd" };
+  const script = path.join(__dirname, "pool_worker.js");
+
+  // El .wasm se compila una vez aquí y cada worker (también los que
+  // reemplazan a uno caído) lo recibe ya compilado. Si falla, cada worker
+  // compila el suyo.
+  const compilado = require("./index.js").compileWasm(env.GRADESOLVER_WASM).catch(() => null);
+
+  const cola = [];
+  const libres = [];
+  const enCurso = new Map();  // worker -> tarea
+  const workers = new Set();
+  let siguienteId = 1;
+  let cerrado = false;
+
+  const latencias = new Float64Array(MUESTRAS_LATENCIA);
+  let muestras = 0;
+  const contadores = { completadas: 0, fallidas: 0, rechazadas: 0, esperaTotalMs: 0 };
+
+  function registrarLatencia(ms) {
+    latencias[muestras % MUESTRAS_LATENCIA] = ms;
+    muestras++;
+  }
+
+  function terminar(tarea, error, result) {
+    const ahora = performance.now();
+    contadores.esperaTotalMs += tarea.inicio - tarea.encolada;
+    registrarLatencia(ahora - tarea.encolada);
+    if (error) {
+      contadores.fallidas++;
+      tarea.reject(error);
+    } else {
+      contadores.completadas++;
+      tarea.resolve(result);
+    }
+  }
+
+  function despachar() {
+    while (libres.length > 0 && cola.length > 0) {
+      const worker = libres.pop();
+      const tarea = cola.shift();
+      tarea.inicio = performance.now();
+      enCurso.set(worker, tarea);
+      worker.postMessage({ id: tarea.id, op: tarea.op, input: tarea.input });
+    }
+  }
+
+  function crearWorker() {
+    const worker = new Worker(script, { env });
+    workers.add(worker);
+
+    worker.on("message", ({ id, ok, result, error }) => {
+      const tarea = enCurso.get(worker);
+      if (tarea === undefined || tarea.id !== id) {
+        return;
+      }
+      enCurso.delete(worker);
+      libres.push(worker);
+      terminar(tarea, ok ? null : new Error(error), result);
+      despachar();
+    });
+
+    // Un worker caído rechaza su tarea y se reemplaza
+    const caida = (error) => {
+      if (!workers.delete(worker)) {
+        return;
+      }
+      const indice = libres.indexOf(worker);
+      if (indice !== -1) {
+        libres.splice(indice, 1);
+      }
+      const tarea = enCurso.get(worker);
+      enCurso.delete(worker);
+      if (tarea !== undefined) {
+        terminar(tarea, error instanceof Error ? error : new Error("El worker termino con codigo " + error));
+      }
+      if (!cerrado) {
+        crearWorker();
+      }
+    };
+    worker.on("error", caida);
+    worker.on("exit", caida);
+
+    // Recibe tareas recién después del módulo compilado
+    compilado.then((wasm) => {
+      if (cerrado || !workers.has(worker)) {
+        return;
+      }
+      worker.postMessage({ op: "wasm", wasm });
+      libres.push(worker);
+      despachar();
+    });
+  }
+
+  for (let i = 0; i < size; i++) {
+    crearWorker();
+  }
+
+  function encolar(op, input) {
+    if (cerrado) {
+      return Promise.reject(new Error("El pool esta cerrado"));
+    }
+    if (cola.length >= maxQueue && libres.length === 0) {
+      contadores.rechazadas++;
+      const error = new Error("Cola del pool llena");
+      error.code = "GRADESOLVER_POOL_LLENO";
+      return Promise.reject(error);
+    }
+    return new Promise((resolve, reject) => {
+      cola.push({ id: siguienteId++, op, input, resolve, reject, encolada: performance.now(), inicio: 0 });
+      despachar();
+    });
+  }
+
+  return {
+    /** Igual que `solve`, en un worker del pool. */
+    solve(input) {
+      return encolar("solve", input);
+    },
+
+    /** Igual que `solveBatch`, en un worker del pool. */
+    solveBatch(inputs) {
+      return encolar("solveBatch", inputs);
+    },
+
+    /** Estado de la cola y latencias (ms, desde que se encola hasta que termina). */
+    stats() {
+      const n = Math.min(muestras, MUESTRAS_LATENCIA);
+      const ordenadas = Array.from(latencias.subarray(0, n)).sort((a, b) => a - b);
+      const terminadas = contadores.completadas + contadores.fallidas;
+      return {
+        workers: workers.size,
+        ocupados: enCurso.size,
+        enCola: cola.length,
+        maxCola: maxQueue,
+        completadas: contadores.completadas,
+        fallidas: contadores.fallidas,
+        rechazadas: contadores.rechazadas,
+        esperaPromedioMs: terminadas > 0 ? contadores.esperaTotalMs / terminadas : 0,
+        latenciaMs: {
+          promedio: n > 0 ? ordenadas.reduce((a, b) => a + b, 0) / n : 0,
+          p50: percentil(ordenadas, 0.5),
+          p95: percentil(ordenadas, 0.95),
+          p99: percentil(ordenadas, 0.99),
+          max: n > 0 ? ordenadas[n - 1] : 0,
+        },
+      };
+    },
+
+    /** Termina los workers; las tareas pendientes se rechazan. */
+    async close() {
+      cerrado = true;
+      const pendientes = cola.splice(0);
+      for (const tarea of pendientes) {
+        tarea.reject(new Error("El pool esta cerrado"));
+      }
+      const activos = [...workers];
+      workers.clear();
+      for (const [, tarea] of enCurso) {
+        tarea.reject(new Error("El pool esta cerrado"));
+      }
+      enCurso.clear();
+      libres.length = 0;
+      await Promise.all(activos.map((worker) => worker.terminate()));
+    },
+  };
+}
+
+module.exports = createPool;
+module.exports.createPool = createPool;
+module.exports.default = createPool;
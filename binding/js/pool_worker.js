@@ -0,0 +1,24 @@
+"use strict";
+
+// Worker de pool.js: una instancia WASM por worker, cargada al recibir el
+// módulo compilado (el primer mensaje) para que la primera tarea no pague la
+// instanciación
+const { parentPort } = require("worker_threads");
+const solver = require("./index.js");
+
+parentPort.on("message", async ({ id, op, input, wasm }) => {
+  if (op === "wasm") {
+    if (wasm) {
+      solver.useCompiledWasm(wasm);
+    }
+    solver.wasmVariant().catch(() => {});
+    return;
+  }
+
+  try {
+    const result = op === "solveBatch" ? await solver.solveBatch(input) : await solver.solve(input);
+    parentPort.postMessage({ id, ok: true, result });
+  } catch (error) {
+    parentPort.postMessage({ id, ok: false, error: error.message });
+  }
+});
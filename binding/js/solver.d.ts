@@ -53,6 +53,20 @@ export interface EntradaP {
   media_historica: number;
   /** Desviación estándar histórica de notas. */
   desviacion_estandar: number;
+  /** Semilla para resultados reproducibles (entero no negativo). */
+  semilla?: number;
+  /** Semiancho objetivo de los intervalos; activa el modo de precisión. */
+  precision_objetivo?: number;
+  /** Nivel de confianza del modo de precisión (por defecto 0.95). */
+  confianza?: number;
+  /** Muestreo: "MC" (por defecto), "QMC" (Sobol revuelto) o "IS" (por importancia, eventos raros). */
+  muestreo?: Muestreo;
+}
+
+/** Parámetros opcionales de la Máquina D. */
+export interface EntradaD {
+  /** Planes de la frontera esfuerzo/probabilidad (0 = sin frontera). */
+  puntos_frontera?: number;
 }
 
 /** Entrada completa del solver. */
@@ -61,6 +75,8 @@ export interface EntradaCompleta {
   contexto: Contexto;
   /** Definición de evaluaciones y restricciones. */
   S: EntradaS;
+  /** Generación de planes. */
+  D?: EntradaD;
   /** Parámetros probabilísticos. */
   P: EntradaP;
 }
@@ -102,7 +118,35 @@ export interface PlanEstrategia {
   promedio_final_teorico: number;
 }
 
+/**
+ * Punto de la frontera esfuerzo/probabilidad: nivel 0 es el plan MINIMUM y
+ * nivel 1 todas las pendientes en la nota máxima.
+ */
+export interface PuntoFrontera {
+  nivel: number;
+  /** Notas objetivo por evaluación pendiente. */
+  notas_objetivo: Record<string, number>;
+  /** Promedio final teórico si se ejecuta el plan. */
+  promedio_final_teorico: number;
+  /** Probabilidad de lograr el plan y aprobar. */
+  probabilidad_del_plan: number;
+  /** Probabilidad de haber cumplido el plan dado que aprobó. */
+  viabilidad: number;
+  /** Intervalo de confianza de probabilidad_del_plan. */
+  intervalo_plan: IntervaloConfianza;
+}
+
 /** Reporte probabilístico para una estrategia. */
+/** Muestreo de escenarios de la Máquina P. */
+export type Muestreo = "MC" | "QMC" | "IS";
+
+/** Intervalo de confianza de una probabilidad. */
+export interface IntervaloConfianza {
+  inferior: number;
+  superior: number;
+}
+
+/** Reporte probabilístico de un plan. */
 export interface ReporteProbabilidad {
   /** Probabilidad de lograr exactamente el plan. */
   probabilidad_del_plan: number;
@@ -110,6 +154,25 @@ export interface ReporteProbabilidad {
   probabilidad_general: number;
   /** Viabilidad del plan (del_plan / general). */
   viabilidad: number;
+  /** Intervalos de confianza (Wilson) de las tres probabilidades. */
+  intervalos: {
+    /** Nivel de confianza de los intervalos (p. ej. 0.95). */
+    confianza: number;
+    probabilidad_general: IntervaloConfianza;
+    probabilidad_del_plan: IntervaloConfianza;
+    viabilidad: IntervaloConfianza;
+  };
+  /** Escenarios simulados realmente. */
+  simulaciones_usadas: number;
+  /** Muestreo usado (QMC cae a MC con más de 32 evaluaciones pendientes o menos de 16 simulaciones). */
+  muestreo: Muestreo;
+  /** Error estándar relativo de probabilidad_general (null si es 0). */
+  error_relativo: number | null;
+  /**
+   * Por evaluación pendiente: cuánto sube probabilidad_general por cada punto
+   * que suba la nota esperada en esa evaluación (∂P/∂media).
+   */
+  sensibilidades: Record<string, number>;
   /** Detalle por evaluación si está disponible. */
   detalle_por_evaluacion?: Record<
     string,
@@ -144,6 +207,8 @@ export interface SalidaCompleta {
   maquina_d: Record<Estrategia, PlanEstrategia>;
   /** Reportes probabilísticos (Máquina P). */
   maquina_p: Record<Estrategia, ReporteProbabilidad>;
+  /** Frontera esfuerzo/probabilidad, si se pidió con `D.puntos_frontera`. */
+  frontera?: PuntoFrontera[];
   /** Perfil estadístico usado en simulaciones. */
   perfil_usado: PerfilEstadistico;
 }
@@ -165,6 +230,303 @@ export type Salida = SalidaCompleta | SalidaError;
  */
 export function solve(input: EntradaCompleta | string): Promise<Salida>;
 
+/** Entrada de cohorte: un curso y las notas de cada estudiante. */
+export interface EntradaCohorte extends EntradaCompleta {
+  /** Una fila por estudiante, en el orden de `S.evaluaciones` (null = pendiente). */
+  cohorte: (number | null)[][];
+}
+
+/** Resultado de un estudiante de la cohorte. */
+export interface ResultadoEstudiante {
+  /** Resultado de factibilidad (Máquina S). */
+  maquina_s: MaquinaSOutput;
+  /** Planes generados (Máquina D). */
+  maquina_d: Record<Estrategia, PlanEstrategia>;
+  /** Reportes probabilísticos (Máquina P). */
+  maquina_p: Record<Estrategia, ReporteProbabilidad>;
+  /** Frontera esfuerzo/probabilidad, si se pidió con `D.puntos_frontera`. */
+  frontera?: PuntoFrontera[];
+  /** Perfil estadístico usado (ausente si no es posible aprobar). */
+  perfil_usado?: PerfilEstadistico;
+}
+
+/** Salida de una cohorte, en el mismo orden que las filas de entrada. */
+export interface SalidaCohorte {
+  estudiantes: ResultadoEstudiante[];
+}
+
+/**
+ * Resuelve el mismo curso para todos los estudiantes en una sola llamada.
+ * @param input JSON de entrada con la matriz `cohorte`.
+ */
+export function solveCohort(input: EntradaCohorte | string): Promise<SalidaCohorte | SalidaError>;
+
+/**
+ * Resuelve muchas entradas independientes en una sola llamada a WASM.
+ * @param inputs Arreglo de entradas (objetos o JSON strings), o un string con
+ * un arreglo JSON o NDJSON (una entrada por línea).
+ * @returns Una salida por entrada, en el mismo orden; las entradas inválidas
+ * quedan como `SalidaError` en su posición.
+ */
+export function solveBatch(inputs: Array<EntradaCompleta | string> | string): Promise<Salida[]>;
+
+/** Opciones de `solveProgressive`. */
+export interface OpcionesProgresivas {
+  /** Cancela la resolución entre tramos; el iterador rechaza con `signal.reason`. */
+  signal?: AbortSignal;
+  /** Escenarios por tramo, redondeados a bloques de 64 (por defecto 4096). */
+  simulacionesPorTramo?: number;
+}
+
+/** Avance de una resolución por tramos. */
+export interface Progreso {
+  simulaciones_usadas: number;
+  /** Tope de simulaciones; el modo de precisión puede terminar antes. */
+  simulaciones_totales: number;
+  terminado: boolean;
+}
+
+/** Estimación parcial de `solveProgressive`. */
+export interface AvanceProgresivo {
+  progreso: Progreso;
+  /** Probabilidades por estrategia con lo simulado hasta ahora. */
+  maquina_p: Record<string, ReporteProbabilidad>;
+  /** Solo en el último valor: la misma salida de `solve`. */
+  resultado?: SalidaCompleta;
+}
+
+/**
+ * Resuelve de a tramos de la Máquina P, cediendo el hilo entre tramos.
+ * Produce una estimación parcial por tramo; la última trae `resultado`.
+ * Salir del `for await` o abortar `signal` detiene la simulación.
+ */
+export function solveProgressive(
+  input: EntradaCompleta | string,
+  options?: OpcionesProgresivas,
+): AsyncGenerator<AvanceProgresivo, void, undefined>;
+
+/** Opciones de un solver reutilizable. */
+export interface OpcionesSolver {
+  /** Hilos de trabajo (0 = todos los núcleos; sin efecto en la build WASM serial). */
+  hilos?: number;
+}
+
+/** Solver reutilizable: llamadas síncronas sobre el módulo ya instanciado. */
+export interface SolverReutilizable {
+  /** Igual que `solve`, sin esperar al módulo. */
+  solve(input: EntradaCompleta | string): Salida;
+  /** Libera el handle nativo; llamar más de una vez no tiene efecto. */
+  dispose(): void;
+}
+
+/**
+ * Crea un solver reutilizable sobre el módulo compartido del proceso.
+ * @param options Hilos de trabajo.
+ */
+export function createSolver(options?: OpcionesSolver): Promise<SolverReutilizable>;
+
+/** Dimensiones fijas de un solver binario. */
+export interface DimensionesBinarias {
+  evaluaciones: number;
+  tags: number;
+  restricciones: number;
+}
+
+/** Parámetros de la Máquina P para `SolverBinario.solve`. */
+export interface OpcionesBinarias {
+  /** 0 o ausente = valor por defecto de la librería. */
+  simulaciones?: number;
+  /** Semilla de 64 bits (number hasta 2^53 o bigint). */
+  semilla?: number | bigint;
+  muestreo?: Muestreo;
+  /** Usar `perfil` en vez de estimarlo desde las notas conocidas. */
+  usarPerfil?: boolean;
+}
+
+/** Plan de una estrategia en la salida binaria. */
+export interface PlanBinario {
+  estrategia: Estrategia;
+  promedio_final_teorico: number;
+  probabilidad_general: number;
+  probabilidad_del_plan: number;
+  viabilidad: number;
+  /** Notas del escenario completo por posición (conocidas y objetivo). */
+  notas: Float64Array;
+}
+
+/**
+ * Salida de `SolverBinario.solve`. Todos los arreglos son vistas sobre la
+ * memoria WASM, válidas hasta la siguiente llamada a `solve` o `dispose`.
+ * Lo que no aplica queda en NaN.
+ */
+export interface SalidaBinaria {
+  es_posible: boolean;
+  /** (min_supervivencia, min_seguridad, max_posible) por evaluación. */
+  rangos: Float64Array;
+  /** 1 si la restricción es incumplible, 0 si no. */
+  incumplibles: Float64Array;
+  /** En el orden MINIMUM, BALANCED, MAX_WEIGHT_FIRST, MIN_WEIGHT_FIRST. */
+  planes: PlanBinario[];
+}
+
+/**
+ * Solver sin JSON. Las propiedades son vistas sin copia sobre la memoria
+ * WASM: se escriben en su lugar y deben volver a leerse después de cada
+ * `solve`, porque si la memoria crece las vistas anteriores quedan vacías.
+ */
+export interface SolverBinario {
+  /** [nota_minima, nota_maxima, nota_aprobacion]. */
+  readonly contexto: Float64Array;
+  /** [media_historica, desviacion_estandar], usado con `usarPerfil`. */
+  readonly perfil: Float64Array;
+  /** Peso por evaluación. */
+  readonly pesos: Float64Array;
+  /** Nota por evaluación; NaN = pendiente. */
+  readonly notas: Float64Array;
+  /** Valor mínimo por restricción. */
+  readonly minimos: Float64Array;
+  /** Pares (tipo, tag) por restricción; tipo 0 = PROMEDIO_SIMPLE_TAG, 1 = NOTA_MINIMA_INDIVIDUAL_TAG. */
+  readonly restricciones: Int32Array;
+  /** Matriz evaluaciones x tags fila-mayor; 1 si la evaluación tiene el tag. */
+  readonly membresia: Uint8Array;
+  /** Fija la restricción `k` como (tipo, tag). */
+  setRestriccion(k: number, tipo: RestriccionTipo | 0 | 1, tag: number): void;
+  /** Resuelve el curso escrito en las vistas. Lanza si la entrada es inválida. */
+  solve(options?: OpcionesBinarias): SalidaBinaria;
+  /** Libera la memoria WASM del solver. */
+  dispose(): void;
+}
+
+/**
+ * Crea un solver binario con dimensiones fijas.
+ * @param dimensiones Cantidad de evaluaciones, tags y restricciones.
+ */
+export function createBinarySolver(dimensiones: DimensionesBinarias): Promise<SolverBinario>;
+
+/** Instancia el módulo WASM sin resolver nada, para no pagar la carga en la primera llamada. */
+export function ready(): Promise<void>;
+
+/**
+ * Variante del módulo WASM cargada: "hilos" (SIMD128 + pthreads), "simd" o
+ * "base". Se elige la más rápida que el motor soporte; en Node
+ * `GRADESOLVER_WASM` fuerza una.
+ */
+export function wasmVariant(): Promise<"hilos" | "simd" | "base">;
+
+/** Módulo WASM compilado de una variante. */
+export interface WasmCompilado {
+  variante: "hilos" | "simd" | "base";
+  module: WebAssembly.Module;
+}
+
+/**
+ * (Node) Compila sin instanciar el .wasm de la variante que usaría `solve`
+ * (o de `variante`) y lo deja en la cache del proceso. El módulo se puede
+ * enviar a otro hilo con `postMessage`.
+ */
+export function compileWasm(variante?: "hilos" | "simd" | "base"): Promise<WasmCompilado>;
+
+/** (Node) Registra un módulo compilado en otro hilo para no volver a compilarlo. */
+export function useCompiledWasm(compilado: WasmCompilado): void;
+
+/** Opciones del pool de workers. */
+export interface OpcionesPool {
+  /** Workers (por defecto uno por núcleo). */
+  size?: number;
+  /** Tareas esperando antes de rechazar nuevas (por defecto 64 por worker). */
+  maxQueue?: number;
+}
+
+/** Estado del pool; latencias en ms desde que se encola hasta que termina. */
+export interface EstadisticasPool {
+  workers: number;
+  ocupados: number;
+  enCola: number;
+  maxCola: number;
+  completadas: number;
+  fallidas: number;
+  /** Llamadas rechazadas con la cola llena. */
+  rechazadas: number;
+  esperaPromedioMs: number;
+  latenciaMs: { promedio: number; p50: number; p95: number; p99: number; max: number };
+}
+
+/**
+ * Pool de worker_threads (solo Node), cada uno con su instancia WASM. Con
+ * la cola llena las llamadas se rechazan con un error de `code`
+ * "GRADESOLVER_POOL_LLENO".
+ */
+export interface PoolSolver {
+  solve(input: EntradaCompleta | string): Promise<Salida>;
+  solveBatch(inputs: Array<EntradaCompleta | string> | string): Promise<Salida[]>;
+  stats(): EstadisticasPool;
+  /** Termina los workers y rechaza lo pendiente. */
+  close(): Promise<void>;
+}
+
+/** Crea un pool de workers (solo Node; también en "@madmti/gradesolver/pool"). */
+export function createPool(options?: OpcionesPool): PoolSolver;
+
+/** Contadores de la cache de resultados de `solve`. */
+export interface EstadisticasCache {
+  aciertos: number;
+  fallos: number;
+  /** Entradas sin `P.semilla`, que no pasan por la cache. */
+  omitidas: number;
+  expulsadas: number;
+  entradas: number;
+  bytes: number;
+  capacidad_bytes: number;
+}
+
+/** Estadísticas de la cache de resultados. */
+export function cacheStats(): Promise<EstadisticasCache>;
+
+/**
+ * Fija la capacidad de la cache de resultados.
+ * @param megabytes Capacidad en MB (0 la desactiva).
+ */
+export function configureCache(megabytes: number): Promise<void>;
+
+/** Vacía la cache de resultados. */
+export function clearCache(): Promise<void>;
+
+/** Resultado de una sesión incremental (sin Máquina P). */
+export interface ResultadoSesion {
+  /** Resultado de factibilidad (Máquina S). */
+  maquina_s: MaquinaSOutput;
+  /** Planes generados (Máquina D); ausente si no es posible aprobar. */
+  maquina_d?: Record<Estrategia, PlanEstrategia>;
+}
+
+/**
+ * Sesión incremental: el curso queda compilado en memoria WASM. Después de
+ * `dispose()` las demás llamadas lanzan.
+ */
+export interface SesionSolver {
+  /** Fija la nota de una evaluación. Devuelve false si el id no existe. */
+  setGrade(id: string, value: number): boolean;
+  /** Deja una evaluación como pendiente. Devuelve false si el id no existe. */
+  clearGrade(id: string): boolean;
+  /** Si todavía se puede aprobar, sin recalcular el espacio ni los planes. */
+  isPossible(): boolean;
+  /**
+   * Límites de una evaluación pendiente, sin recalcular el espacio ni los
+   * planes. `null` si el id no existe o la evaluación ya tiene nota.
+   */
+  rango(id: string): RangoEvaluacion | null;
+  /** Ruta lenta: recalcula lo que haya cambiado y devuelve espacio y planes. */
+  result(): ResultadoSesion | SalidaError;
+  /** Libera la memoria de la sesión. Llamarlo de nuevo no hace nada. */
+  dispose(): void;
+}
+
+/**
+ * Crea una sesión incremental para actualizar notas una a una.
+ * @param input JSON de entrada como objeto o string.
+ */
+export function createSession(input: EntradaCompleta | string): Promise<SesionSolver>;
+
 /** Módulo Emscripten con la función expuesta para resolver. */
 export interface SolverModule {
   /**
@@ -1,17 +1,16 @@
-#include "interface_s.hpp"
-#include "interface_d.hpp"
 #include "json_serializer.hpp"
+#include "pipeline.hpp"
 #include <cstdio>
-#include <cmath>
-#include <vector>
 #include <string>
 #include <iostream>
 
 void print_usage() {
-    fprintf(stderr, "Uso: solver_cli <archivo.json> [--raw]\n");
+    fprintf(stderr, "Uso: solver_cli <archivo.json> [--raw] [--biseccion] [--hilos N]\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "Opciones:\n");
-    fprintf(stderr, "  --raw    Imprime el resultado en formato JSON por stdout\n");
+    fprintf(stderr, "  --raw        Imprime el resultado en formato JSON por stdout\n");
+    fprintf(stderr, "  --biseccion  Calcula los limites de la Maquina S por biseccion (referencia)\n");
+    fprintf(stderr, "  --hilos N    Hilos de trabajo (0 = todos los nucleos, 1 = serial, por defecto 1)\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "Sin --raw, imprime el resultado formateado en texto.\n");
 }
@@ -27,128 +26,86 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    // Verificar si se activó el modo --raw
+    // Opciones después del archivo
     bool modo_raw = false;
-    if (argc > 2 && std::string(argv[2]) == "--raw") {
-        modo_raw = true;
+    MetodoLimites metodo_limites = MetodoLimites::EXACTO;
+    int hilos = 1;
+    for (int i = 2; i < argc; ++i) {
+        std::string opcion = argv[i];
+        if (opcion == "--raw") {
+            modo_raw = true;
+        } else if (opcion == "--biseccion") {
+            metodo_limites = MetodoLimites::BISECCION;
+        } else if (opcion == "--hilos" && i + 1 < argc) {
+            try {
+                hilos = std::stoi(argv[++i]);
+            } catch (const std::exception&) {
+                fprintf(stderr, "Error: --hilos requiere un numero entero\n\n");
+                print_usage();
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Error: Opcion desconocida: %s\n\n", opcion.c_str());
+            print_usage();
+            return 1;
+        }
     }
 
-    // Variables de entrada
-    Contexto contexto;
-    std::vector<Evaluacion> evaluaciones;
-    std::vector<Restriccion> restricciones;
-    int simulaciones = 10000;
-    PerfilEstadistico perfil;
-    bool usar_perfil_del_json = false;
-
     // Cargar desde archivo JSON
+    EntradaCompleta entrada;
     try {
         std::string filepath = argv[1];
         if (!modo_raw) {
             fprintf(stderr, "Cargando configuracion desde: %s\n\n", filepath.c_str());
         }
 
-        auto entrada = parse_entrada_from_file(filepath);
-
-        contexto = entrada.contexto;
-        evaluaciones = entrada.evaluaciones;
-        restricciones = entrada.restricciones;
-
-        if (entrada.simulaciones.has_value()) {
-            simulaciones = entrada.simulaciones.value();
-        }
-
-        if (entrada.perfil.has_value()) {
-            perfil = entrada.perfil.value();
-            usar_perfil_del_json = true;
-        }
+        entrada = parse_entrada_from_file(filepath);
 
     } catch (const std::exception& e) {
         fprintf(stderr, "Error al parsear JSON: %s\n", e.what());
         return 1;
     }
 
-    // Crear las máquinas
-    MaquinaS maquina_s { contexto };
-    MaquinaD maquina_d { contexto };
-    MaquinaP maquina_p { contexto };
+    // ========== PIPELINE S -> D -> P ==========
+    OpcionesSolver opciones;
+    opciones.hilos = hilos;
+    opciones.metodo_limites = metodo_limites;
+    const SalidaCompleta salida = resolver(entrada, opciones);
+    const auto& espacio = salida.espacio_soluciones;
 
-    // ========== MAQUINA S: Calcular Espacio de Soluciones ==========
-    auto espacio = maquina_s.calcular_espacio(evaluaciones, restricciones);
+    // En modo raw se imprime la salida tal cual, sea posible o no
+    if (modo_raw) {
+        auto j = to_json(salida);
+        std::cout << j.dump() << std::endl;
+        return 0;
+    }
 
     // Si no es posible, mostrar error y salir
     if (!espacio.es_posible) {
-        if (!modo_raw) {
-            fprintf(stderr, "========================================\n");
-            fprintf(stderr, "ERROR: NO ES POSIBLE APROBAR\n");
-            fprintf(stderr, "========================================\n");
-            fprintf(stderr, "\nRESTRICCIONES INCUMPLIBLES:\n");
-            for (const auto& restriccion : espacio.restricciones_incumplibles) {
-                fprintf(stderr, "  - %s\n", restriccion.c_str());
-            }
-            fprintf(stderr, "\n>> No es posible aprobar incluso con notas maximas en evaluaciones pendientes.\n");
-            fprintf(stderr, ">> Sugerencia: Revisar con el profesor opciones de recuperacion.\n\n");
+        fprintf(stderr, "========================================\n");
+        fprintf(stderr, "ERROR: NO ES POSIBLE APROBAR\n");
+        fprintf(stderr, "========================================\n");
+        fprintf(stderr, "\nRESTRICCIONES INCUMPLIBLES:\n");
+        for (const auto& restriccion : espacio.restricciones_incumplibles) {
+            fprintf(stderr, "  - %s\n", restriccion.c_str());
         }
-
-        // En modo raw, igual generar el JSON con la información
-        if (modo_raw) {
-            SalidaCompleta salida;
-            salida.contexto = contexto;
-            salida.evaluaciones = evaluaciones;
-            salida.restricciones = restricciones;
-            salida.espacio_soluciones = espacio;
-            
-            auto j = to_json(salida);
-            std::cout << j.dump() << std::endl;
-        }
-
+        fprintf(stderr, "\n>> No es posible aprobar incluso con notas maximas en evaluaciones pendientes.\n");
+        fprintf(stderr, ">> Sugerencia: Revisar con el profesor opciones de recuperacion.\n\n");
         return 0;
     }
 
-    // ========== MAQUINA D: Generar Plan de Notas ==========
-    auto plan_minimum = maquina_d.generar_plan(espacio, evaluaciones, restricciones, TipoEstrategia::MINIMUM);
-    auto plan_balanced = maquina_d.generar_plan(espacio, evaluaciones, restricciones, TipoEstrategia::BALANCED);
-    auto plan_max_weight = maquina_d.generar_plan(espacio, evaluaciones, restricciones, TipoEstrategia::MAX_WEIGHT_FIRST);
-    auto plan_min_weight = maquina_d.generar_plan(espacio, evaluaciones, restricciones, TipoEstrategia::MIN_WEIGHT_FIRST);
-
-    // ========== MAQUINA P: Analizar Probabilidades ==========
+    const auto& plan_minimum = salida.planes.at("MINIMUM");
+    const auto& plan_balanced = salida.planes.at("BALANCED");
+    const auto& plan_max_weight = salida.planes.at("MAX_WEIGHT_FIRST");
+    const auto& plan_min_weight = salida.planes.at("MIN_WEIGHT_FIRST");
 
-    // Calcular perfil estadístico si no se proporcionó en el JSON
-    if (!usar_perfil_del_json) {
-        std::vector<double> notas_existentes;
-        for (const auto& eval : evaluaciones) {
-            if (eval.valor_actual.has_value()) {
-                notas_existentes.push_back(eval.valor_actual.value());
-            }
-        }
+    const auto& reporte_minimum = salida.reportes_probabilidad.at("MINIMUM");
+    const auto& reporte_balanced = salida.reportes_probabilidad.at("BALANCED");
+    const auto& reporte_max_weight = salida.reportes_probabilidad.at("MAX_WEIGHT_FIRST");
+    const auto& reporte_min_weight = salida.reportes_probabilidad.at("MIN_WEIGHT_FIRST");
 
-        if (!notas_existentes.empty()) {
-            double suma = 0.0;
-            for (double n : notas_existentes) suma += n;
-            perfil.media_historica = suma / notas_existentes.size();
-
-            double suma_cuadrados = 0.0;
-            for (double n : notas_existentes) {
-                double diff = n - perfil.media_historica;
-                suma_cuadrados += diff * diff;
-            }
-            perfil.desviacion_estandar = std::sqrt(suma_cuadrados / notas_existentes.size());
-
-            // Desviación mínima: 10% del rango de notas (escalable a cualquier sistema)
-            double desv_minima = (contexto.nota_maxima - contexto.nota_minima) * 0.10;
-            if (perfil.desviacion_estandar < desv_minima) {
-                perfil.desviacion_estandar = desv_minima;
-            }
-        } else {
-            perfil.media_historica = contexto.nota_aprobacion + (contexto.nota_maxima - contexto.nota_aprobacion) * 0.2;
-            perfil.desviacion_estandar = (contexto.nota_maxima - contexto.nota_minima) / 4.0;
-        }
-    }
-
-    auto reporte_minimum = maquina_p.analizar(espacio, plan_minimum, evaluaciones, restricciones, perfil, simulaciones);
-    auto reporte_balanced = maquina_p.analizar(espacio, plan_balanced, evaluaciones, restricciones, perfil, simulaciones);
-    auto reporte_max_weight = maquina_p.analizar(espacio, plan_max_weight, evaluaciones, restricciones, perfil, simulaciones);
-    auto reporte_min_weight = maquina_p.analizar(espacio, plan_min_weight, evaluaciones, restricciones, perfil, simulaciones);
+    const auto& perfil = salida.perfil_usado.value();
+    const auto& frontera = salida.frontera;
 
     // ========== GENERAR RECOMENDACIÓN ==========
     double mejor_prob = std::max(std::max(reporte_minimum.probabilidad_del_plan, reporte_balanced.probabilidad_del_plan),
@@ -181,32 +138,6 @@ int main(int argc, char* argv[]) {
         recomendacion = "ALTO RIESGO - Considera mejorar desempeño general ✗";
     }
 
-    // ========== MODO RAW: Imprimir JSON ==========
-    if (modo_raw) {
-        SalidaCompleta salida;
-        salida.contexto = contexto;
-        salida.evaluaciones = evaluaciones;
-        salida.restricciones = restricciones;
-        salida.espacio_soluciones = espacio;
-
-        salida.planes["MINIMUM"] = plan_minimum;
-        salida.planes["BALANCED"] = plan_balanced;
-        salida.planes["MAX_WEIGHT_FIRST"] = plan_max_weight;
-        salida.planes["MIN_WEIGHT_FIRST"] = plan_min_weight;
-
-        salida.reportes_probabilidad["MINIMUM"] = reporte_minimum;
-        salida.reportes_probabilidad["BALANCED"] = reporte_balanced;
-        salida.reportes_probabilidad["MAX_WEIGHT_FIRST"] = reporte_max_weight;
-        salida.reportes_probabilidad["MIN_WEIGHT_FIRST"] = reporte_min_weight;
-
-        salida.perfil_usado = perfil;
-
-        auto j = to_json(salida);
-        std::cout << j.dump() << std::endl;
-
-        return 0;
-    }
-
     // ========== MODO NORMAL: Imprimir Formateado ==========
 
     printf("========================================\n");
@@ -250,6 +181,8 @@ int main(int argc, char* argv[]) {
     printf("MAQUINA P - ANALISIS DE PROBABILIDADES\n");
     printf("========================================\n");
     printf("PERFIL: Media=%.2f, Desv=%.2f\n", perfil.media_historica, perfil.desviacion_estandar);
+    printf("SIMULACIONES: %d (intervalos al %.0f%%)\n", reporte_minimum.simulaciones_usadas,
+           reporte_minimum.confianza * 100);
 
     printf("\n%-28s | %10s | %10s | %10s | %10s\n", "METRICA", "MINIMUM", "BALANCED", "MAX_W", "MIN_W");
     printf("------------------------------------------------------------------------------------\n");
@@ -268,6 +201,23 @@ int main(int argc, char* argv[]) {
            reporte_balanced.viabilidad * 100,
            reporte_max_weight.viabilidad * 100,
            reporte_min_weight.viabilidad * 100);
+    printf("%-28s | %9.2f%% | %9.2f%% | %9.2f%% | %9.2f%%\n", "+/- Prob. del Plan",
+           reporte_minimum.intervalo_plan.semiancho() * 100,
+           reporte_balanced.intervalo_plan.semiancho() * 100,
+           reporte_max_weight.intervalo_plan.semiancho() * 100,
+           reporte_min_weight.intervalo_plan.semiancho() * 100);
+
+    if (!frontera.empty()) {
+        printf("\n%-10s | %16s | %14s | %14s\n", "NIVEL", "PROMEDIO TEORICO", "PROB. PLAN", "VIABILIDAD");
+        printf("-------------------------------------------------------------------\n");
+        for (const auto& punto : frontera) {
+            printf("%-10.2f | %16.2f | %13.2f%% | %13.2f%%\n",
+                   punto.nivel,
+                   punto.plan.promedio_final_teorico,
+                   punto.reporte.probabilidad_del_plan * 100,
+                   punto.reporte.viabilidad * 100);
+        }
+    }
 
     printf("\n========================================\n");
     printf("RESUMEN FINAL\n");
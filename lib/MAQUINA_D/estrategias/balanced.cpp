@@ -1,50 +1,18 @@
-#include "../interface_d.hpp"
-#include <map>
-#include <algorithm>
+#include "registro.hpp"
+#include "subida.hpp"
+#include <vector>
 
-void aplicar_estrategia_balanced(
-    std::map<std::string, double>& escenario,
-    const Contexto& ctx,
-    const std::vector<Evaluacion>& evaluaciones) {
-    
+void EstrategiaBalanced::aplicar(std::vector<double>& escenario, const PreparacionPlanes& prep) {
     // BALANCED: Calcular la nota común mínima necesaria para aprobar
-    // considerando el promedio ponderado y las evaluaciones ya realizadas
-    
-    // Calcular el peso total de evaluaciones pendientes
-    double peso_pendiente = 0.0;
-    double suma_ponderada_actual = 0.0;
-    
-    for (const auto& eval : evaluaciones) {
-        if (eval.valor_actual.has_value()) {
-            // Ya tiene nota, sumar al ponderado actual
-            suma_ponderada_actual += eval.valor_actual.value() * eval.peso;
-        } else {
-            // Pendiente, acumular peso
-            peso_pendiente += eval.peso;
-        }
-    }
-    
-    // Calcular la nota común necesaria
-    // Fórmula: suma_ponderada_actual + (nota_comun * peso_pendiente) = nota_aprobacion
-    // Despejando: nota_comun = (nota_aprobacion - suma_ponderada_actual) / peso_pendiente
-    
-    double nota_comun;
-    
-    if (peso_pendiente > 0.0) {
-        nota_comun = (ctx.nota_aprobacion - suma_ponderada_actual) / peso_pendiente;
-        
-        // Asegurar que la nota común esté en el rango válido
-        nota_comun = std::max(nota_comun, ctx.nota_minima);
-        nota_comun = std::min(nota_comun, ctx.nota_maxima);
-    } else {
-        // No hay evaluaciones pendientes, usar nota de aprobación por defecto
-        nota_comun = ctx.nota_aprobacion;
-    }
-    
-    // Aplicar la nota común a todas las evaluaciones pendientes
-    for (const auto& eval : evaluaciones) {
-        if (!eval.valor_actual.has_value()) {
-            escenario[eval.id] = nota_comun;
-        }
-    }
-}
\ No newline at end of file
+    // considerando el promedio ponderado y las evaluaciones ya realizadas.
+    //
+    // Sin restricciones por tag la nota común es
+    // (nota_aprobacion - suma_ponderada_actual) / peso_pendiente; con ellas,
+    // las que un tag obliga a subir quedan sobre la nota común y el resto se
+    // nivela en la menor nota común que aprueba.
+    std::vector<double> base(escenario.size());
+    prep.curso.llenar_escenario(base, prep.ctx.nota_minima);
+    escenario = base;
+
+    subir_plan(escenario, base, prep.curso, ModoSubida::NIVEL);
+}
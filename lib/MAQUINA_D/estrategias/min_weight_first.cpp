@@ -1,34 +1,17 @@
-#include "../interface_d.hpp"
-#include <map>
-#include <algorithm>
+#include "registro.hpp"
+#include "subida.hpp"
 #include <vector>
 
-void aplicar_estrategia_min_weight_first(
-    std::map<std::string, double>& escenario,
-    const EspacioSoluciones& espacio,
-    const std::vector<Evaluacion>& evaluaciones) {
-    
+void EstrategiaMinWeightFirst::aplicar(std::vector<double>& escenario, const PreparacionPlanes& prep) {
     // MIN_WEIGHT_FIRST: Concentrar esfuerzo en evaluaciones de menor peso
     // Las de menor peso: nota alta (más fáciles de sacar)
     // Las de mayor peso: nota mínima posible
 
-    // Ordenar evaluaciones pendientes por peso (menor a mayor)
-    std::vector<const Evaluacion*> pendientes;
-    for (const auto& eval : evaluaciones) {
-        if (!eval.valor_actual.has_value()) {
-            pendientes.push_back(&eval);
-        }
-    }
-    std::sort(pendientes.begin(), pendientes.end(),
-              [](const Evaluacion* a, const Evaluacion* b) { return a->peso < b->peso; });
-
     // Inicializar todas con el mínimo
-    for (const auto* eval : pendientes) {
-        if (espacio.rangos_por_evaluacion.count(eval->id)) {
-            escenario[eval->id] = espacio.rangos_por_evaluacion.at(eval->id).min_supervivencia;
-        }
-    }
+    escenario = prep.minimos;
 
     // Subir solo las primeras (menor peso) lo necesario para alcanzar nota_aprobacion
-    // dejando las últimas (mayor peso) en el mínimo
-}
\ No newline at end of file
+    // dejando las últimas (mayor peso) en el mínimo: mochila fraccionaria, cada
+    // una llega a la nota máxima antes de tocar la siguiente
+    subir_plan(escenario, prep.minimos, prep.curso, ModoSubida::PRIORIDAD, prep.por_peso_ascendente);
+}
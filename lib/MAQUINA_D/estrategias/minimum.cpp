@@ -1,15 +1,12 @@
-#include "../interface_d.hpp"
-#include <map>
+#include "registro.hpp"
+#include "subida.hpp"
+#include <vector>
 
-void aplicar_estrategia_minimum(
-    std::map<std::string, double>& escenario,
-    const EspacioSoluciones& espacio,
-    const std::vector<Evaluacion>& evaluaciones) {
-    
+void EstrategiaMinimum::aplicar(std::vector<double>& escenario, const PreparacionPlanes& prep) {
     // MINIMUM: Usar el mínimo absoluto (min_supervivencia) para cada evaluación
-    for (const auto& eval : evaluaciones) {
-        if (!eval.valor_actual.has_value() && espacio.rangos_por_evaluacion.count(eval.id)) {
-            escenario[eval.id] = espacio.rangos_por_evaluacion.at(eval.id).min_supervivencia;
-        }
-    }
-}
\ No newline at end of file
+    escenario = prep.minimos;
+
+    // Si con todas en su mínimo no alcanza, subir todas lo mismo (sin pasar
+    // la nota máxima) hasta el menor desplazamiento que cumple
+    subir_plan(escenario, prep.minimos, prep.curso, ModoSubida::UNIFORME);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "../interface_d.hpp"
+#include <array>
+#include <string_view>
+#include <vector>
+
+// ============================================================================
+// REGISTRO DE ESTRATEGIAS
+// ----------------------------------------------------------------------------
+// Cada estrategia es una clase con su TipoEstrategia, su nombre en la salida
+// y un `aplicar` estático que completa las notas pendientes del escenario.
+// El registro es la lista de clases; el despacho se resuelve en compilación
+// (sin if-chain ni funciones virtuales) y la cantidad de estrategias y sus
+// nombres salen de él. Para agregar una estrategia: sumar su valor a
+// TipoEstrategia, definir la clase en su propio archivo de estrategias/ y
+// agregarla a `Estrategias`, cuyo orden es el de generación y reporte.
+// ============================================================================
+
+// Lo que comparten todas las estrategias de un curso, calculado una vez
+struct PreparacionPlanes {
+    const Contexto& ctx;
+    const EspacioSoluciones& espacio;
+    const CursoCompilado& curso;
+
+    // Notas conocidas y cada pendiente en su mínimo de supervivencia (0.0 si
+    // la Máquina S no le dio rango)
+    std::vector<double> minimos;
+
+    // Pendientes por peso; a igual peso, en orden de entrada
+    std::vector<int> por_peso_descendente;
+    std::vector<int> por_peso_ascendente;
+
+    PreparacionPlanes(const Contexto& ctx, const EspacioSoluciones& espacio, const CursoCompilado& curso);
+};
+
+struct EstrategiaMinimum {
+    static constexpr TipoEstrategia tipo = TipoEstrategia::MINIMUM;
+    static constexpr std::string_view nombre = "MINIMUM";
+    static void aplicar(std::vector<double>& escenario, const PreparacionPlanes& prep);
+};
+
+struct EstrategiaBalanced {
+    static constexpr TipoEstrategia tipo = TipoEstrategia::BALANCED;
+    static constexpr std::string_view nombre = "BALANCED";
+    static void aplicar(std::vector<double>& escenario, const PreparacionPlanes& prep);
+};
+
+struct EstrategiaMaxWeightFirst {
+    static constexpr TipoEstrategia tipo = TipoEstrategia::MAX_WEIGHT_FIRST;
+    static constexpr std::string_view nombre = "MAX_WEIGHT_FIRST";
+    static void aplicar(std::vector<double>& escenario, const PreparacionPlanes& prep);
+};
+
+struct EstrategiaMinWeightFirst {
+    static constexpr TipoEstrategia tipo = TipoEstrategia::MIN_WEIGHT_FIRST;
+    static constexpr std::string_view nombre = "MIN_WEIGHT_FIRST";
+    static void aplicar(std::vector<double>& escenario, const PreparacionPlanes& prep);
+};
+
+template <typename... E>
+struct RegistroEstrategias {
+    static constexpr std::array<TipoEstrategia, sizeof...(E)> tipos { E::tipo... };
+    static constexpr std::array<std::string_view, sizeof...(E)> nombres { E::nombre... };
+
+    // Aplica la estrategia `tipo`; false si no está registrada
+    static bool aplicar(TipoEstrategia tipo, std::vector<double>& escenario, const PreparacionPlanes& prep) {
+        return ((E::tipo == tipo ? (E::aplicar(escenario, prep), true) : false) || ...);
+    }
+};
+
+using Estrategias = RegistroEstrategias<
+    EstrategiaMinimum,
+    EstrategiaBalanced,
+    EstrategiaMaxWeightFirst,
+    EstrategiaMinWeightFirst
+>;
+
+// Los valores registrados son 0..n-1 (cada uno una vez), para indexar por
+// TipoEstrategia, y los nombres no se repiten
+constexpr bool registro_completo() {
+    constexpr size_t n = Estrategias::tipos.size();
+    std::array<int, n> veces {};
+    for (auto tipo : Estrategias::tipos) {
+        if (static_cast<size_t>(tipo) >= n) return false;
+        veces[static_cast<size_t>(tipo)]++;
+    }
+    for (int v : veces) if (v != 1) return false;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) if (Estrategias::nombres[i] == Estrategias::nombres[j]) return false;
+    }
+    return true;
+}
+static_assert(registro_completo(), "Estrategias debe listar cada TipoEstrategia exactamente una vez, con nombres distintos");
@@ -0,0 +1,188 @@
+#include "subida.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+// Tramo del camino de una pendiente: con el parámetro en t su nota es
+// nota_inicial + clamp(t, desde, hasta) - desde
+struct Tramo {
+    int idx;
+    double coef;
+    double desde;
+    double hasta;
+};
+
+// Menor t con Σ coef·(clamp(t, desde, hasta) - desde) >= deficit, o el
+// final del último tramo si no alcanza. Entre dos extremos consecutivos la
+// suma crece con pendiente igual a la suma de coeficientes de los tramos
+// activos.
+double resolver_tramos(const std::vector<Tramo>& tramos, double deficit) {
+    std::vector<std::pair<double, double>> extremos;  // (posición, cambio de pendiente)
+    extremos.reserve(2 * tramos.size());
+    for (const auto& tramo : tramos) {
+        if (tramo.coef <= 0.0 || tramo.hasta <= tramo.desde) continue;
+        extremos.emplace_back(tramo.desde, tramo.coef);
+        extremos.emplace_back(tramo.hasta, -tramo.coef);
+    }
+    if (extremos.empty()) return 0.0;
+    std::sort(extremos.begin(), extremos.end());
+
+    double t = extremos.front().first;
+    double ganado = 0.0;
+    double pendiente = 0.0;
+    for (const auto& [posicion, cambio] : extremos) {
+        const double tramo_ganado = pendiente * (posicion - t);
+        if (pendiente > 0.0 && ganado + tramo_ganado >= deficit) {
+            return t + (deficit - ganado) / pendiente;
+        }
+        ganado += tramo_ganado;
+        t = posicion;
+        pendiente += cambio;
+    }
+    return t;
+}
+
+} // namespace
+
+void subir_plan(std::vector<double>& escenario,
+                const std::vector<double>& base,
+                const CursoCompilado& curso,
+                ModoSubida modo,
+                std::span<const int> orden) {
+    const double techo = curso.ctx.nota_maxima;
+
+    // Pendientes en el orden en que se recorren (solo importa en PRIORIDAD)
+    std::vector<int> pendientes(orden.begin(), orden.end());
+    if (modo != ModoSubida::PRIORIDAD || pendientes.empty()) pendientes = curso.pendientes;
+
+    std::vector<size_t> rango(curso.size(), 0);
+    for (size_t k = 0; k < pendientes.size(); ++k) rango[pendientes[k]] = k;
+
+    // Sube `indices` (ya en orden de prioridad) lo justo para que
+    // Σ coef(idx)·nota aumente en `deficit`
+    std::vector<Tramo> tramos;
+    auto subir = [&](const std::vector<int>& indices, auto&& coef, double deficit) {
+        tramos.clear();
+        double acumulado = 0.0;
+        for (int idx : indices) {
+            const double nota = escenario[idx];
+            switch (modo) {
+                case ModoSubida::UNIFORME:
+                    tramos.push_back({ idx, coef(idx), nota - base[idx], techo - base[idx] });
+                    break;
+                case ModoSubida::NIVEL:
+                    tramos.push_back({ idx, coef(idx), nota, techo });
+                    break;
+                case ModoSubida::PRIORIDAD:
+                    tramos.push_back({ idx, coef(idx), acumulado, acumulado + (techo - nota) });
+                    acumulado += techo - nota;
+                    break;
+            }
+        }
+
+        const double t = resolver_tramos(tramos, deficit);
+        for (const auto& tramo : tramos) {
+            if (tramo.hasta <= tramo.desde) continue;
+            escenario[tramo.idx] += std::clamp(t, tramo.desde, tramo.hasta) - tramo.desde;
+        }
+    };
+
+    // 1. Notas mínimas por tag: cada pendiente del tag sube al mínimo
+    for (const auto& res : curso.restricciones) {
+        if (res.tipo != TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG) continue;
+        for (int m : res.miembros) {
+            if (!curso.es_conocida(m)) escenario[m] = std::max(escenario[m], std::min(res.valor_minimo, techo));
+        }
+    }
+
+    // 2. Promedios simples por tag: lo que falta para la suma del tag se
+    //    reparte entre sus pendientes según el modo
+    std::vector<int> miembros;
+    for (const auto& res : curso.restricciones) {
+        if (res.tipo != TipoRestriccion::PROMEDIO_SIMPLE_TAG || res.miembros.empty()) continue;
+
+        double suma = 0.0;
+        miembros.clear();
+        for (int m : res.miembros) {
+            suma += escenario[m];
+            if (!curso.es_conocida(m)) miembros.push_back(m);
+        }
+        const double deficit = res.valor_minimo * res.miembros.size() - suma;
+        if (deficit <= 0.0) continue;
+
+        std::sort(miembros.begin(), miembros.end(), [&](int a, int b) { return rango[a] < rango[b]; });
+        subir(miembros, [](int) { return 1.0; }, deficit);
+    }
+
+    // 3. Promedio global ponderado, partiendo de las notas que dejaron los tags
+    const double deficit = curso.ctx.nota_aprobacion - promedio_ponderado(curso, escenario);
+    if (deficit > 0.0) {
+        subir(pendientes, [&](int idx) { return curso.pesos[idx]; }, deficit);
+    }
+
+    // 4. El despeje es exacto salvo redondeo: si una suma quedó un ulp bajo
+    //    su mínimo, empujar las notas de esa restricción al siguiente double
+    auto empujar = [&](int idx) {
+        if (!curso.es_conocida(idx)) escenario[idx] = std::nextafter(escenario[idx], techo);
+    };
+    auto corregir_redondeo = [&] {
+        for (int ronda = 0; ronda < 64 && !validar_escenario(curso, escenario); ++ronda) {
+            if (promedio_ponderado(curso, escenario) < curso.ctx.nota_aprobacion) {
+                for (int idx : curso.pendientes) empujar(idx);
+            }
+            for (const auto& res : curso.restricciones) {
+                if (!evaluar_restriccion(res, escenario)) {
+                    for (int m : res.miembros) empujar(m);
+                }
+            }
+        }
+    };
+    corregir_redondeo();
+
+    // 5. Minimalidad conjunta: los promedios por tag se resuelven de a uno,
+    //    así que con tags que comparten evaluaciones la subida de un tag
+    //    posterior puede dejar holgura en uno anterior. Cada pendiente baja
+    //    lo que permite la holgura de todas sus restricciones, sin pasar
+    //    bajo su nota base, en orden inverso de prioridad. Bajar una nota no
+    //    da holgura a ninguna restricción, así que tras una pasada ninguna
+    //    nota puede bajar sin romper alguna. Si el curso es imposible las
+    //    notas quedan en el techo.
+    if (validar_escenario(curso, escenario)) {
+        const double umbral = 1e-12 * (techo - curso.ctx.nota_minima);
+
+        std::vector<double> holgura(curso.restricciones.size(), 0.0);
+        for (size_t r = 0; r < curso.restricciones.size(); ++r) {
+            const auto& res = curso.restricciones[r];
+            if (res.tipo != TipoRestriccion::PROMEDIO_SIMPLE_TAG) continue;
+            for (int m : res.miembros) holgura[r] += escenario[m];
+            holgura[r] -= res.valor_minimo * res.miembros.size();
+        }
+        double holgura_global = promedio_ponderado(curso, escenario) - curso.ctx.nota_aprobacion;
+
+        for (auto it = pendientes.rbegin(); it != pendientes.rend(); ++it) {
+            const int idx = *it;
+            const double peso = curso.pesos[idx];
+
+            double bajada = escenario[idx] - base[idx];
+            if (peso > 0.0) bajada = std::min(bajada, holgura_global / peso);
+            for (int r : curso.restricciones_por_evaluacion[idx]) {
+                const auto& res = curso.restricciones[r];
+                bajada = std::min(bajada, res.tipo == TipoRestriccion::PROMEDIO_SIMPLE_TAG
+                                              ? holgura[r]
+                                              : escenario[idx] - std::min(res.valor_minimo, techo));
+            }
+            if (!(bajada > umbral)) continue;
+
+            escenario[idx] -= bajada;
+            holgura_global -= peso * bajada;
+            for (int r : curso.restricciones_por_evaluacion[idx]) {
+                if (curso.restricciones[r].tipo == TipoRestriccion::PROMEDIO_SIMPLE_TAG) holgura[r] -= bajada;
+            }
+        }
+    }
+
+    // Las bajadas dejan restricciones justas en su mínimo, de nuevo salvo redondeo
+    corregir_redondeo();
+}
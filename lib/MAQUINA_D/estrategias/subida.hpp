@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../interface_d.hpp"
+#include <span>
+#include <vector>
+
+// ============================================================================
+// SUBIDA EXACTA DE UN PLAN
+// ----------------------------------------------------------------------------
+// Todas las restricciones son cotas inferiores de sumas con coeficientes
+// positivos (promedio global ponderado, promedio simple de un tag, nota
+// mínima de un tag), así que un plan se arregla subiendo notas pendientes.
+// Cada estrategia define un camino de subida con un parámetro t: la nota de
+// cada pendiente crece con pendiente 1 mientras t recorre su tramo
+// [desde, hasta]. La suma a cumplir es lineal por tramos en t, y el menor t
+// que la cumple sale de un barrido sobre los extremos ordenados, sin iterar.
+// ============================================================================
+
+enum class ModoSubida {
+    UNIFORME,   // Todas suben lo mismo desde la nota base (MINIMUM)
+    NIVEL,      // Las que quedan bajo un nivel común suben hasta él (BALANCED)
+    PRIORIDAD   // Una a la vez, en el orden dado, hasta la nota máxima (MAX/MIN_WEIGHT_FIRST)
+};
+
+// Sube las notas pendientes de `escenario` lo mínimo necesario para cumplir
+// las restricciones por tag y luego el promedio global, según `modo`, y
+// después baja las que quedaron con holgura: ninguna nota del plan puede
+// bajar sin romper una restricción. `base` es el escenario del que parte el
+// camino (UNIFORME) y el piso de cada pendiente; debe ser un vector
+// distinto de `escenario`. `orden` es la prioridad de las pendientes
+// (PRIORIDAD). Si el curso es imposible las notas quedan en la nota máxima.
+void subir_plan(std::vector<double>& escenario,
+                const std::vector<double>& base,
+                const CursoCompilado& curso,
+                ModoSubida modo,
+                std::span<const int> orden = {});
@@ -1,27 +1,46 @@
 #include "interface_d.hpp"
-#include <map>
+#include "estrategias/registro.hpp"
 #include <algorithm>
+#include <map>
+#include <stdexcept>
+
+std::span<const TipoEstrategia> estrategias_registradas() {
+    return Estrategias::tipos;
+}
 
-// Declaraciones de las funciones de estrategias
-void aplicar_estrategia_minimum(
-    std::map<std::string, double>& escenario,
-    const EspacioSoluciones& espacio,
-    const std::vector<Evaluacion>& evaluaciones);
+std::string_view nombre_estrategia(TipoEstrategia tipo) {
+    for (size_t i = 0; i < Estrategias::tipos.size(); ++i) {
+        if (Estrategias::tipos[i] == tipo) return Estrategias::nombres[i];
+    }
+    throw std::runtime_error("TipoEstrategia desconocido");
+}
 
-void aplicar_estrategia_balanced(
-    std::map<std::string, double>& escenario,
-    const Contexto& ctx,
-    const std::vector<Evaluacion>& evaluaciones);
+std::optional<TipoEstrategia> estrategia_por_nombre(std::string_view nombre) {
+    for (size_t i = 0; i < Estrategias::nombres.size(); ++i) {
+        if (Estrategias::nombres[i] == nombre) return Estrategias::tipos[i];
+    }
+    return std::nullopt;
+}
 
-void aplicar_estrategia_max_weight_first(
-    std::map<std::string, double>& escenario,
-    const EspacioSoluciones& espacio,
-    const std::vector<Evaluacion>& evaluaciones);
+PreparacionPlanes::PreparacionPlanes(const Contexto& ctx, const EspacioSoluciones& espacio,
+                                     const CursoCompilado& curso)
+    : ctx(ctx), espacio(espacio), curso(curso), minimos(curso.size()) {
+    // Una sola búsqueda por id en los rangos de la Máquina S
+    curso.llenar_escenario(minimos, 0.0);
+    for (int idx : curso.pendientes) {
+        auto it = espacio.rangos_por_evaluacion.find(curso.ids[idx]);
+        if (it != espacio.rangos_por_evaluacion.end()) {
+            minimos[idx] = it->second.min_supervivencia;
+        }
+    }
 
-void aplicar_estrategia_min_weight_first(
-    std::map<std::string, double>& escenario,
-    const EspacioSoluciones& espacio,
-    const std::vector<Evaluacion>& evaluaciones);
+    por_peso_descendente = curso.pendientes;
+    std::stable_sort(por_peso_descendente.begin(), por_peso_descendente.end(),
+                     [&](int a, int b) { return curso.pesos[a] > curso.pesos[b]; });
+    por_peso_ascendente = curso.pendientes;
+    std::stable_sort(por_peso_ascendente.begin(), por_peso_ascendente.end(),
+                     [&](int a, int b) { return curso.pesos[a] < curso.pesos[b]; });
+}
 
 MaquinaD::MaquinaD(const Contexto& contexto) : ctx(contexto) {}
 
@@ -29,165 +48,72 @@ Sugerencias MaquinaD::generar_plan(const EspacioSoluciones& espacio,
                                   const std::vector<Evaluacion>& evaluaciones,
                                   const std::vector<Restriccion>& restricciones,
                                   TipoEstrategia estrategia) {
-    Sugerencias sug;
-    sug.estrategia_aplicada = estrategia;
-
-    // Construir escenario inicial con las notas según estrategia
-    std::map<std::string, double> escenario;
-
-    // Inicializar con valores conocidos
-    for (const auto& eval : evaluaciones) {
-        if (eval.valor_actual.has_value()) {
-            escenario[eval.id] = *eval.valor_actual;
-        }
-    }
-
-    // Aplicar estrategia para evaluaciones pendientes
-    if (estrategia == TipoEstrategia::MINIMUM) {
-        aplicar_estrategia_minimum(escenario, espacio, evaluaciones);
-    }
-    else if (estrategia == TipoEstrategia::BALANCED) {
-        aplicar_estrategia_balanced(escenario, ctx, evaluaciones);
-    }
-    else if (estrategia == TipoEstrategia::MAX_WEIGHT_FIRST) {
-        aplicar_estrategia_max_weight_first(escenario, espacio, evaluaciones);
-    }
-    else if (estrategia == TipoEstrategia::MIN_WEIGHT_FIRST) {
-        aplicar_estrategia_min_weight_first(escenario, espacio, evaluaciones);
-    }
-
-    // Crear lista ordenada según estrategia para ajustes
-    std::vector<const Evaluacion*> orden_prioridad;
-    for (const auto& eval : evaluaciones) {
-        if (!eval.valor_actual.has_value()) {
-            orden_prioridad.push_back(&eval);
-        }
-    }
+    return generar_plan(espacio, compilar_curso(ctx, evaluaciones, restricciones), estrategia);
+}
 
-    // Ordenar según estrategia
-    if (estrategia == TipoEstrategia::MAX_WEIGHT_FIRST) {
-        std::sort(orden_prioridad.begin(), orden_prioridad.end(),
-                 [](const Evaluacion* a, const Evaluacion* b) { return a->peso > b->peso; });
-    } else if (estrategia == TipoEstrategia::MIN_WEIGHT_FIRST) {
-        std::sort(orden_prioridad.begin(), orden_prioridad.end(),
-                 [](const Evaluacion* a, const Evaluacion* b) { return a->peso < b->peso; });
-    }
+Sugerencias MaquinaD::generar_plan(const EspacioSoluciones& espacio,
+                                  const CursoCompilado& curso,
+                                  TipoEstrategia estrategia) {
+    return generar_planes(espacio, curso, std::span<const TipoEstrategia>(&estrategia, 1))[0];
+}
 
-    // Ajustar iterativamente hasta cumplir todas las restricciones
-    for (int iter = 0; iter < 1000; ++iter) {
-        if (validar_escenario(escenario, evaluaciones, restricciones)) {
-            break; // Ya cumple todo
-        }
+std::vector<Sugerencias> MaquinaD::generar_planes(const EspacioSoluciones& espacio,
+                                                  const CursoCompilado& curso,
+                                                  std::span<const TipoEstrategia> estrategias) {
+    const PreparacionPlanes prep(ctx, espacio, curso);
 
-        // 1. Verificar y ajustar promedio global
-        double promedio_actual = 0.0;
-        for (const auto& eval : evaluaciones) {
-            promedio_actual += escenario.at(eval.id) * eval.peso;
-        }
+    std::vector<Sugerencias> planes;
+    planes.reserve(estrategias.size());
 
-        if (promedio_actual < ctx.nota_aprobacion) {
-            // Incrementar según estrategia
-            if (estrategia == TipoEstrategia::MAX_WEIGHT_FIRST || estrategia == TipoEstrategia::MIN_WEIGHT_FIRST) {
-                // Subir en orden de prioridad
-                bool ajustado_promedio = false;
-                for (const auto* eval : orden_prioridad) {
-                    if (escenario[eval->id] < ctx.nota_maxima) {
-                        escenario[eval->id] = std::min(escenario[eval->id] + 1.0, ctx.nota_maxima);
-                        ajustado_promedio = true;
-                        break; // Una a la vez
-                    }
-                }
-                if (!ajustado_promedio) {
-                    break; // No se puede ajustar más
-                }
-            } else {
-                // Para BALANCED y MINIMUM, subir todas
-                for (const auto& eval : evaluaciones) {
-                    if (!eval.valor_actual.has_value()) {
-                        escenario[eval.id] = std::min(escenario[eval.id] + 1.0, ctx.nota_maxima);
-                    }
-                }
-            }
-            continue; // Volver a verificar promedio
-        }
+    // Escenario de trabajo: valores conocidos y pendientes en 0.0
+    std::vector<double> escenario(curso.size());
+    for (auto estrategia : estrategias) {
+        curso.llenar_escenario(escenario, 0.0);
 
-        // 2. Revisar cada restricción por tag que falle
-        bool alguna_restriccion_fallo = false;
-        for (const auto& res : restricciones) {
-            if (!evaluar_restriccion(res, escenario, evaluaciones)) {
-                alguna_restriccion_fallo = true;
-                // Esta restricción falla, ajustar evaluaciones pendientes con ese tag
-                for (const auto& eval : evaluaciones) {
-                    if (!eval.valor_actual.has_value() &&
-                        std::find(eval.tags.begin(), eval.tags.end(), res.tag_objetivo) != eval.tags.end()) {
-                        escenario[eval.id] = std::min(escenario[eval.id] + 3.0, ctx.nota_maxima);
-                    }
-                }
-                break; // Ajustar una restricción a la vez
-            }
-        }
+        // Cada estrategia deja el plan mínimo que cumple todas las
+        // restricciones (o en la nota máxima si el curso es imposible)
+        Estrategias::aplicar(estrategia, escenario, prep);
 
-        // Si no hay restricciones que arreglar y el promedio ya está bien, terminar
-        if (!alguna_restriccion_fallo && promedio_actual >= ctx.nota_aprobacion) {
-            break;
-        }
-    }
+        Sugerencias sug;
+        sug.estrategia_aplicada = estrategia;
 
-    // Guardar las sugerencias finales
-    for (const auto& eval : evaluaciones) {
-        if (!eval.valor_actual.has_value()) {
-            sug.notas_objetivo[eval.id] = escenario[eval.id];
+        // Guardar las sugerencias finales
+        for (int idx : curso.pendientes) {
+            sug.notas_objetivo[curso.ids[idx]] = escenario[idx];
         }
-    }
-
-    // Calcular promedio ponderado final
-    double suma_ponderada = 0.0;
-    for (const auto& eval : evaluaciones) {
-        suma_ponderada += escenario[eval.id] * eval.peso;
-    }
-
-    sug.promedio_final_teorico = suma_ponderada;
-    return sug;
-}
-
-bool MaquinaD::validar_escenario(const std::map<std::string, double>& escenario,
-                                  const std::vector<Evaluacion>& evaluaciones,
-                                  const std::vector<Restriccion>& restricciones) {
-    // Promedio Ponderado Total
-    double total = 0.0;
-    for (const auto& eval : evaluaciones) {
-        total += escenario.at(eval.id) * eval.peso;
-    }
-    if (total < ctx.nota_aprobacion) return false;
 
-    // Restricciones por Tag
-    for (const auto& res : restricciones) {
-        if (!evaluar_restriccion(res, escenario, evaluaciones)) return false;
+        // Calcular promedio ponderado final
+        sug.promedio_final_teorico = promedio_ponderado(curso, escenario);
+        planes.push_back(std::move(sug));
     }
-    return true;
+    return planes;
 }
 
-bool MaquinaD::evaluar_restriccion(const Restriccion& res,
-                                    const std::map<std::string, double>& escenario,
-                                    const std::vector<Evaluacion>& evaluaciones) {
-    std::vector<double> notas;
-
-    for (const auto& eval : evaluaciones) {
-        if (std::find(eval.tags.begin(), eval.tags.end(), res.tag_objetivo) != eval.tags.end()) {
-            notas.push_back(escenario.at(eval.id));
+std::vector<PlanFrontera> MaquinaD::generar_frontera(const EspacioSoluciones& espacio,
+                                                     const CursoCompilado& curso,
+                                                     int puntos) {
+    std::vector<PlanFrontera> frontera;
+    if (puntos <= 0) return frontera;
+    frontera.reserve(puntos);
+
+    // Extremo inferior: el plan MINIMUM
+    const PreparacionPlanes prep(ctx, espacio, curso);
+    std::vector<double> minimo(curso.size());
+    curso.llenar_escenario(minimo, 0.0);
+    Estrategias::aplicar(TipoEstrategia::MINIMUM, minimo, prep);
+
+    std::vector<double> escenario = minimo;
+    for (int k = 0; k < puntos; ++k) {
+        const double nivel = puntos > 1 ? static_cast<double>(k) / (puntos - 1) : 0.0;
+
+        // Sin estrategia: el plan no sale de ninguna de las registradas
+        PlanFrontera punto{ nivel, {} };
+        for (int idx : curso.pendientes) {
+            escenario[idx] = minimo[idx] + nivel * (ctx.nota_maxima - minimo[idx]);
+            punto.plan.notas_objetivo[curso.ids[idx]] = escenario[idx];
         }
+        punto.plan.promedio_final_teorico = promedio_ponderado(curso, escenario);
+        frontera.push_back(std::move(punto));
     }
-
-    if (notas.empty()) return true;
-
-    if (res.tipo == TipoRestriccion::PROMEDIO_SIMPLE_TAG) {
-        double suma = 0;
-        for (double n : notas) suma += n;
-        return (suma / notas.size()) >= res.valor_minimo;
-    }
-    else if (res.tipo == TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG) {
-        for (double n : notas) if (n < res.valor_minimo) return false;
-        return true;
-    }
-    return true;
-}
\ No newline at end of file
+    return frontera;
+}
@@ -1,21 +1,41 @@
 #pragma once
 
+#include <optional>
+#include <span>
+#include <string_view>
 #include "interface_s.hpp"
 
 enum class TipoEstrategia {
     MAX_WEIGHT_FIRST,  // Priorizar evaluaciones con mayor peso
     MIN_WEIGHT_FIRST,  // Priorizar evaluaciones con menor peso
-    BALANCED,          // Misma nota para todas las evaluaciones
+    BALANCED,          // Nivelar: la menor nota común que cumple, subiendo solo lo que un tag exige
     MINIMUM            // Mínima nota posible para cada evaluación
 };
 
+// Estrategias registradas, en el orden en que se generan y se reportan. Sus
+// valores son 0..size()-1, así que sirven de índice.
+std::span<const TipoEstrategia> estrategias_registradas();
+
+// Nombre de la estrategia en la salida ("MINIMUM", "BALANCED", ...); lanza
+// std::runtime_error si no está registrada
+std::string_view nombre_estrategia(TipoEstrategia tipo);
+
+// Estrategia registrada con ese nombre (nullopt si no hay)
+std::optional<TipoEstrategia> estrategia_por_nombre(std::string_view nombre);
+
 struct Sugerencias {
     // ID de evaluación -> Nota sugerida para el usuario
     std::map<std::string, double> notas_objetivo;
-    TipoEstrategia estrategia_aplicada;
+    std::optional<TipoEstrategia> estrategia_aplicada;  // Vacía en los planes de la frontera
     double promedio_final_teorico;
 };
 
+// Plan de la frontera esfuerzo/probabilidad con su nivel en [0, 1]
+struct PlanFrontera {
+    double nivel;
+    Sugerencias plan;
+};
+
 class MaquinaD {
 public:
     MaquinaD(const Contexto& contexto);
@@ -26,14 +46,26 @@ public:
                              const std::vector<Restriccion>& restricciones,
                              TipoEstrategia estrategia);
 
-private:
-    Contexto ctx;
+    // Variante sobre un curso ya compilado
+    Sugerencias generar_plan(const EspacioSoluciones& espacio,
+                             const CursoCompilado& curso,
+                             TipoEstrategia estrategia);
 
-    bool validar_escenario(const std::map<std::string, double>& escenario,
-                          const std::vector<Evaluacion>& evaluaciones,
-                          const std::vector<Restriccion>& restricciones);
+    // Genera varios planes compartiendo una sola pasada sobre las
+    // pendientes (mínimos y órdenes por peso). Un plan por estrategia, en el
+    // mismo orden.
+    std::vector<Sugerencias> generar_planes(const EspacioSoluciones& espacio,
+                                            const CursoCompilado& curso,
+                                            std::span<const TipoEstrategia> estrategias = estrategias_registradas());
 
-    bool evaluar_restriccion(const Restriccion& res,
-                            const std::map<std::string, double>& escenario,
-                            const std::vector<Evaluacion>& evaluaciones);
+    // Familia de `puntos` planes entre el plan MINIMUM (nivel 0) y todas las
+    // pendientes en la nota máxima (nivel 1): el k-ésimo tiene nivel
+    // k / (puntos - 1) y cada nota es minimo + nivel * (nota_maxima - minimo).
+    // Como las restricciones son monótonas, todos los planes las cumplen.
+    std::vector<PlanFrontera> generar_frontera(const EspacioSoluciones& espacio,
+                                               const CursoCompilado& curso,
+                                               int puntos);
+
+private:
+    Contexto ctx;
 };
@@ -1,122 +1,644 @@
 #include "interface_p.hpp"
 #include <algorithm>
-#include <random>
+#include <atomic>
+#include <cmath>
+#include "aleatorio.hpp"
+#include "kernel_bloques.hpp"
+#include "sobol.hpp"
+#include "paralelo.hpp"
 
-MaquinaP::MaquinaP(const Contexto &contexto) : ctx(contexto) {}
+namespace {
+
+// Puntajes de las sensibilidades, uno por bloque de ANCHO_BLOQUE escenarios.
+// Se acumulan en orden de bloque, así que el resultado no depende de cómo se
+// repartan los bloques entre hilos.
+struct PuntajesPorBloque {
+    size_t columnas;             // 2 por evaluación pendiente
+    std::vector<double> bloques; // `columnas` por bloque de la tanda actual
+    std::vector<double> total;
+
+    explicit PuntajesPorBloque(size_t pendientes) : columnas(2 * pendientes), total(columnas, 0.0) {}
+
+    void nueva_tanda(size_t cantidad) { bloques.assign(cantidad * columnas, 0.0); }
+
+    double *sumas(size_t bloque) { return bloques.data() + bloque * columnas; }
+
+    void acumular_tanda() {
+        for (size_t i = 0; i < bloques.size(); i += columnas) {
+            for (size_t c = 0; c < columnas; ++c) total[c] += bloques[i + c];
+        }
+    }
+};
+
+// ∂P(aprobar)/∂(media de cada pendiente) por razón de verosimilitud:
+// E[w·1[aprueba]·s] / desviacion. Como E[w·s] = 0, se resta como variable de
+// control con coeficiente `probabilidad`.
+std::map<std::string, double> calcular_sensibilidades(const CursoCompilado &curso, const std::vector<double> &total,
+                                                      double usadas, double probabilidad, double desviacion) {
+    std::map<std::string, double> sensibilidades;
+    if (usadas <= 0 || !(desviacion > 0)) return sensibilidades;
+
+    for (size_t d = 0; d < curso.pendientes.size(); ++d) {
+        sensibilidades[curso.ids[curso.pendientes[d]]] =
+            (total[2 * d] - probabilidad * total[2 * d + 1]) / (usadas * desviacion);
+    }
+    return sensibilidades;
+}
+
+} // namespace
+
+MaquinaP::MaquinaP(const Contexto &contexto, std::optional<uint64_t> semilla, int hilos)
+    : ctx(contexto), semilla(semilla), hilos(hilos) {}
 
 ReporteProbabilidad
     MaquinaP::analizar(const EspacioSoluciones &espacio, const Sugerencias &plan,
                    const std::vector<Evaluacion> &evaluaciones,
                    const std::vector<Restriccion> &restricciones,
                    const PerfilEstadistico &perfil, int simulaciones) {
-    ReporteProbabilidad reporte;
+    return analizar(espacio, plan, compilar_curso(ctx, evaluaciones, restricciones), perfil, simulaciones);
+}
+
+ReporteProbabilidad
+    MaquinaP::analizar(const EspacioSoluciones &espacio, const Sugerencias &plan,
+                   const CursoCompilado &curso,
+                   const PerfilEstadistico &perfil, int simulaciones) {
+    return analizar_planes(espacio, std::span<const Sugerencias>(&plan, 1), curso, perfil, simulaciones)[0];
+}
+
+std::vector<ReporteProbabilidad>
+    MaquinaP::analizar_planes(const EspacioSoluciones &espacio, std::span<const Sugerencias> planes,
+                          const CursoCompilado &curso,
+                          const PerfilEstadistico &perfil, int simulaciones,
+                          const std::optional<PrecisionObjetivo> &precision, Muestreo muestreo) {
+    auto analisis = analizar_por_tramos(espacio, planes, curso, perfil, simulaciones, precision, muestreo, 0);
+    while (analisis.avanzar()) {}
+    return analisis.tomar_reportes();
+}
+
+AnalisisPorTramos
+    MaquinaP::analizar_por_tramos(const EspacioSoluciones &espacio, std::span<const Sugerencias> planes,
+                              const CursoCompilado &curso, PerfilEstadistico perfil, int simulaciones,
+                              std::optional<PrecisionObjetivo> precision, Muestreo muestreo,
+                              int simulaciones_por_tramo) {
+    const size_t n = curso.size();
+    const size_t k = planes.size();
+    const int tope = std::max(simulaciones, 0);
+
+    const GeneradorContador generador(semilla.value_or(semilla_aleatoria()));
+
+    // Nota objetivo de cada plan por evaluación (fila por plan; NaN si el plan no la fija)
+    std::vector<double> objetivo(k * n, std::numeric_limits<double>::quiet_NaN());
+    for (size_t p = 0; p < k; ++p) {
+        for (const auto &[id, nota] : planes[p].notas_objetivo) {
+            int idx = curso.indice(id);
+            if (idx >= 0) objetivo[p * n + idx] = nota;
+        }
+    }
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::normal_distribution<double> dist(perfil.media_historica,
-                                            perfil.desviacion_estandar);
+    const DatosBloque datos { &curso, &generador, perfil.media_historica, perfil.desviacion_estandar,
+                              ctx.nota_minima, ctx.nota_maxima, objetivo.data(), k };
 
-    int veces_aprueba = 0;              // Cuántas veces aprueba (cualquier manera)
-    int veces_logra_plan_y_aprueba = 0; // Cuántas veces logra plan Y aprueba
-    int veces_aprueba_con_plan = 0;     // De las que aprobó, cuántas cumplieron plan
+    // Los tramos son bloques enteros, así que no cambian qué escenarios se
+    // simulan ni el orden en que se acumulan
+    const size_t tramo = simulaciones_por_tramo > 0
+        ? (static_cast<size_t>(simulaciones_por_tramo) + ANCHO_BLOQUE - 1) / ANCHO_BLOQUE * ANCHO_BLOQUE
+        : 0;
+
+    // QMC necesita una dimensión de Sobol por evaluación pendiente y al
+    // menos un punto por réplica
+    const bool qmc = muestreo == Muestreo::QMC && tope >= REPLICAS_QMC &&
+                     curso.pendientes.size() <= static_cast<size_t>(SecuenciaSobol::MAX_DIMENSIONES);
+    // La propuesta de importancia se escala por la desviación: sin dispersión
+    // no hay a dónde desplazarla y se simula con Monte Carlo
+    const bool importancia = muestreo == Muestreo::IMPORTANCIA && perfil.desviacion_estandar > 0.0;
+    if (qmc || importancia) {
+        auto analisis = qmc ? analizar_qmc(curso, datos, tope, precision, tramo)
+                            : analizar_importancia(espacio, curso, datos, tope, precision, tramo);
+        while (analisis.avanzar()) co_yield analisis.reportes();
+        co_return analisis.tomar_reportes();
+    }
+
+    std::atomic<int> veces_aprueba { 0 };                        // Cuántas veces aprueba (cualquier manera)
+    std::vector<std::atomic<int>> veces_logra_plan_y_aprueba(k); // Por plan: cuántas veces logra plan Y aprueba
+    PuntajesPorBloque puntajes(curso.pendientes.size());
+
+    // Simula los escenarios [desde, hasta) por bloques de ANCHO_BLOQUE. Cada
+    // escenario usa su propio flujo aleatorio y los bloques no dependen del
+    // reparto, así que los resultados son los mismos con cualquier cantidad
+    // de hilos. El mismo escenario se contrasta con todos los planes
+    // (números aleatorios comunes).
+    auto simular = [&](size_t desde, size_t hasta) {
+        const size_t bloques = (hasta - desde + ANCHO_BLOQUE - 1) / ANCHO_BLOQUE;
+        puntajes.nueva_tanda(bloques);
+
+        ejecutar_en_paralelo(bloques, hilos, MIN_BLOQUES_POR_HILO,
+                             [&](size_t inicio, size_t fin) {
+            int aprueba_local = 0;
+            std::vector<int> plan_y_aprueba_local(k, 0);
+
+            // Notas por columnas: las conocidas quedan fijas y solo se
+            // sobrescriben las filas pendientes
+            std::vector<double> notas(n * ANCHO_BLOQUE);
+            std::vector<double> normales(curso.pendientes.size() * ANCHO_BLOQUE);
+            preparar_bloque(curso, notas.data());
+            EvaluadorEscenarios evaluador(curso);
+
+            for (size_t b = inicio; b < fin; ++b) {
+                const size_t i = desde + b * ANCHO_BLOQUE;
+                const size_t ancho = std::min(ANCHO_BLOQUE, hasta - i);
+                const PuntajesBloque puntajes_bloque { normales.data(), puntajes.sumas(b) };
+                simular_bloque(datos, evaluador, i, ancho, notas.data(), aprueba_local, plan_y_aprueba_local.data(),
+                               &puntajes_bloque);
+            }
 
-    for (int i = 0; i < simulaciones; ++i) {
-        std::map<std::string, double> escenario;
-        bool cumple_plan = true;
+            veces_aprueba += aprueba_local;
+            for (size_t p = 0; p < k; ++p) veces_logra_plan_y_aprueba[p] += plan_y_aprueba_local[p];
+        });
+        puntajes.acumular_tanda();
+    };
 
-        // Generar notas aleatorias según perfil
-        for (const auto &eval : evaluaciones) {
-            if (eval.valor_actual.has_value()) {
-                escenario[eval.id] = *eval.valor_actual;
+    const double confianza = precision.has_value() ? precision->confianza : 0.95;
+    const double z = z_confianza(confianza);
+
+    // Semiancho más grande entre todos los intervalos con `usadas` escenarios
+    auto peor_semiancho = [&](int usadas) {
+        double peor = intervalo_wilson(veces_aprueba, usadas, z).semiancho();
+        for (size_t p = 0; p < k; ++p) {
+            peor = std::max(peor, intervalo_wilson(veces_logra_plan_y_aprueba[p], usadas, z).semiancho());
+            peor = std::max(peor, intervalo_wilson(veces_logra_plan_y_aprueba[p], veces_aprueba, z).semiancho());
+        }
+        return peor;
+    };
+
+    // Reportes con los primeros `usadas` escenarios
+    auto armar_reportes = [&](int usadas) {
+        const auto sensibilidades = calcular_sensibilidades(curso, puntajes.total, usadas,
+                                                            static_cast<double>(veces_aprueba) / std::max(usadas, 1),
+                                                            datos.desviacion);
+
+        std::vector<ReporteProbabilidad> reportes(k);
+        for (size_t p = 0; p < k; ++p) {
+            auto &reporte = reportes[p];
+            const int aprueba = veces_aprueba;
+            const int logra_plan_y_aprueba = veces_logra_plan_y_aprueba[p];
+
+            // 1. Probabilidad general de aprobar (sin considerar plan)
+            reporte.probabilidad_general = static_cast<double>(aprueba) / usadas;
+
+            // 2. Probabilidad de lograr el plan Y aprobar
+            reporte.probabilidad_del_plan = static_cast<double>(logra_plan_y_aprueba) / usadas;
+
+            // 3. Viabilidad: P(cumplió plan | aprobó)
+            if (aprueba > 0) {
+                reporte.viabilidad = static_cast<double>(logra_plan_y_aprueba) / aprueba;
             } else {
-                double nota_simulada = std::clamp(dist(gen), ctx.nota_minima, ctx.nota_maxima);
-                escenario[eval.id] = nota_simulada;
-
-                // ¿Esta nota cumple o supera el plan?
-                if (plan.notas_objetivo.count(eval.id)) {
-                    if (nota_simulada < plan.notas_objetivo.at(eval.id)) {
-                        cumple_plan = false;
-                    }
-                }
+                reporte.viabilidad = 0.0;
             }
+
+            reporte.confianza = confianza;
+            reporte.intervalo_general = intervalo_wilson(aprueba, usadas, z);
+            reporte.intervalo_plan = intervalo_wilson(logra_plan_y_aprueba, usadas, z);
+            reporte.intervalo_viabilidad = intervalo_wilson(logra_plan_y_aprueba, aprueba, z);
+            reporte.simulaciones_usadas = usadas;
+            if (aprueba > 0) {
+                const double p_general = reporte.probabilidad_general;
+                reporte.error_relativo = std::sqrt((1.0 - p_general) / (usadas * p_general));
+            }
+            reporte.sensibilidades = sensibilidades;
+        }
+        return reportes;
+    };
+
+    int usadas = 0;
+    if (!precision.has_value()) {
+        while (usadas < tope) {
+            const int fin = tramo > 0 ? static_cast<int>(std::min<size_t>(tope, usadas + tramo)) : tope;
+            simular(static_cast<size_t>(usadas), static_cast<size_t>(fin));
+            usadas = fin;
+            if (usadas < tope) co_yield armar_reportes(usadas);
+        }
+    } else {
+        // Por bloques: el tamaño del siguiente bloque se estima con el
+        // semiancho actual (decrece como 1/sqrt(n)), entre un bloque mínimo y
+        // duplicar lo simulado
+        int bloque = std::min(TAM_BLOQUE_PRECISION, tope);
+        while (bloque > 0) {
+            const int fin_bloque = usadas + bloque;
+            while (usadas < fin_bloque) {
+                const int fin = tramo > 0 ? static_cast<int>(std::min<size_t>(fin_bloque, usadas + tramo))
+                                          : fin_bloque;
+                simular(static_cast<size_t>(usadas), static_cast<size_t>(fin));
+                usadas = fin;
+                if (usadas < fin_bloque) co_yield armar_reportes(usadas);
+            }
+
+            const double peor = peor_semiancho(usadas);
+            if (peor <= precision->semiancho || usadas >= tope) break;
+            co_yield armar_reportes(usadas);
+
+            const double razon = peor / precision->semiancho;
+            const double estimado = usadas * razon * razon;
+            const double siguiente = std::clamp(estimado - usadas, static_cast<double>(TAM_BLOQUE_PRECISION),
+                                                static_cast<double>(usadas));
+            bloque = static_cast<int>(std::min(siguiente, static_cast<double>(tope - usadas)));
         }
+    }
+
+    co_return armar_reportes(usadas);
+}
+
+namespace {
+
+// Intervalo a partir de estimaciones independientes (réplicas QMC) centrado
+// en `centro`. Si el conteo total está en un extremo (0 o todos) las réplicas
+// no tienen dispersión y se usa Wilson sobre el total.
+IntervaloConfianza intervalo_replicas(const std::vector<double> &estimaciones, double centro,
+                                      long long exitos, long long total, double t, double z) {
+    if (exitos == 0 || exitos == total) return intervalo_wilson(exitos, total, z);
+
+    const double r = static_cast<double>(estimaciones.size());
+    double media = 0.0;
+    for (double e : estimaciones) media += e;
+    media /= r;
+
+    double suma_cuadrados = 0.0;
+    for (double e : estimaciones) suma_cuadrados += (e - media) * (e - media);
+    const double margen = t * std::sqrt(suma_cuadrados / (r - 1.0) / r);
+
+    return { std::max(0.0, centro - margen), std::min(1.0, centro + margen) };
+}
+
+} // namespace
+
+AnalisisPorTramos
+    MaquinaP::analizar_qmc(const CursoCompilado &curso, const DatosBloque &datos,
+                       int simulaciones, std::optional<PrecisionObjetivo> precision, size_t tramo) {
+    constexpr int R = REPLICAS_QMC;
+    const size_t n = curso.size();
+    const size_t k = datos.planes;
+    const int dimensiones = static_cast<int>(curso.pendientes.size());
+    const SecuenciaSobol sobol(std::max(dimensiones, 1));
+
+    // Revoltura independiente por réplica y dimensión
+    std::vector<uint32_t> semillas(static_cast<size_t>(R) * std::max(dimensiones, 1));
+    for (int r = 0; r < R; ++r) {
+        const uint64_t flujo = datos.generador->flujo(static_cast<uint64_t>(r));
+        for (int d = 0; d < dimensiones; ++d) {
+            semillas[r * dimensiones + d] = static_cast<uint32_t>(GeneradorContador::bits(flujo, d) >> 32);
+        }
+    }
+
+    // Conteos por réplica (y por plan)
+    std::vector<std::atomic<int>> aprueba(R);
+    std::vector<std::atomic<int>> plan_y_aprueba(static_cast<size_t>(R) * k);
+
+    // Puntajes por réplica, combinados en orden de réplica: así el total no
+    // depende de cómo se repartan los puntos en tramos o bloques
+    std::vector<PuntajesPorBloque> puntajes(R, PuntajesPorBloque(curso.pendientes.size()));
 
-        // Validar si aprueba con este escenario
-        bool aprueba = validar_escenario(escenario, evaluaciones, restricciones);
+    // Agrega los puntos [desde, hasta) de cada réplica. Un solo reparto
+    // sobre réplica × bloque: con pocos puntos por réplica los hilos siguen
+    // teniendo trabajo y se sincronizan una vez por tramo, no una por réplica
+    auto simular = [&](size_t desde, size_t hasta) {
+        const size_t bloques = (hasta - desde + ANCHO_BLOQUE - 1) / ANCHO_BLOQUE;
+        for (auto &replica : puntajes) replica.nueva_tanda(bloques);
 
-        if (aprueba) {
-            veces_aprueba++;
-            
-            // Si aprobó cumpliendo el plan
-            if (cumple_plan) {
-                veces_aprueba_con_plan++;
+        ejecutar_en_paralelo(static_cast<size_t>(R) * bloques, hilos, MIN_BLOQUES_POR_HILO,
+                             [&](size_t inicio, size_t fin) {
+            int aprueba_local = 0;
+            std::vector<int> plan_y_aprueba_local(k, 0);
+
+            std::vector<double> notas(n * ANCHO_BLOQUE);
+            std::vector<double> normales(curso.pendientes.size() * ANCHO_BLOQUE);
+            preparar_bloque(curso, notas.data());
+            EvaluadorEscenarios evaluador(curso);
+
+            // Los conteos locales se vuelcan al cambiar de réplica
+            size_t r = inicio / bloques;
+            auto volcar = [&]() {
+                aprueba[r] += aprueba_local;
+                for (size_t p = 0; p < k; ++p) plan_y_aprueba[r * k + p] += plan_y_aprueba_local[p];
+                aprueba_local = 0;
+                std::fill(plan_y_aprueba_local.begin(), plan_y_aprueba_local.end(), 0);
+            };
+
+            for (size_t j = inicio; j < fin; ++j) {
+                if (j / bloques != r) {
+                    volcar();
+                    r = j / bloques;
+                }
+                const size_t b = j % bloques;
+                const size_t i = desde + b * ANCHO_BLOQUE;
+                const size_t ancho = std::min(ANCHO_BLOQUE, hasta - i);
+                const PuntajesBloque puntajes_bloque { normales.data(), puntajes[r].sumas(b) };
+                simular_bloque_sobol(datos, evaluador, sobol, semillas.data() + r * dimensiones, i, ancho,
+                                     notas.data(), aprueba_local, plan_y_aprueba_local.data(), &puntajes_bloque);
             }
+            volcar();
+        });
+
+        for (auto &replica : puntajes) replica.acumular_tanda();
+    };
+
+    const double confianza = precision.has_value() ? precision->confianza : 0.95;
+    const double t = t_confianza(confianza, R - 1);
+    const double z = z_confianza(confianza);
+
+    // Reportes con `m` puntos por réplica
+    auto armar_reportes = [&](int m) {
+        const long long total = static_cast<long long>(R) * m;
+        long long total_aprueba = 0;
+        std::vector<double> est_general(R);
+        for (int r = 0; r < R; ++r) {
+            total_aprueba += aprueba[r];
+            est_general[r] = static_cast<double>(aprueba[r]) / m;
         }
+        const double general = static_cast<double>(total_aprueba) / total;
+        std::vector<double> total_puntajes(puntajes[0].columnas, 0.0);
+        for (const auto &replica : puntajes) {
+            for (size_t c = 0; c < total_puntajes.size(); ++c) total_puntajes[c] += replica.total[c];
+        }
+        const auto sensibilidades = calcular_sensibilidades(curso, total_puntajes, static_cast<double>(total),
+                                                            general, datos.desviacion);
 
-        // Si cumplió plan Y aprobó
-        if (cumple_plan && aprueba) {
-            veces_logra_plan_y_aprueba++;
+        std::vector<ReporteProbabilidad> reportes(k);
+        std::vector<double> est_plan(R), est_viabilidad(R);
+        for (size_t p = 0; p < k; ++p) {
+            long long total_plan = 0;
+            for (int r = 0; r < R; ++r) {
+                const int logra = plan_y_aprueba[r * k + p];
+                total_plan += logra;
+                est_plan[r] = static_cast<double>(logra) / m;
+                est_viabilidad[r] = aprueba[r] > 0 ? static_cast<double>(logra) / aprueba[r] : 0.0;
+            }
+
+            auto &reporte = reportes[p];
+            reporte.probabilidad_general = general;
+            reporte.probabilidad_del_plan = static_cast<double>(total_plan) / total;
+            reporte.viabilidad = total_aprueba > 0 ? static_cast<double>(total_plan) / total_aprueba : 0.0;
+
+            reporte.confianza = confianza;
+            reporte.intervalo_general = intervalo_replicas(est_general, general, total_aprueba, total, t, z);
+            reporte.intervalo_plan = intervalo_replicas(est_plan, reporte.probabilidad_del_plan, total_plan, total, t, z);
+            reporte.intervalo_viabilidad = intervalo_replicas(est_viabilidad, reporte.viabilidad,
+                                                              total_plan, total_aprueba, t, z);
+            reporte.simulaciones_usadas = static_cast<int>(total);
+            reporte.muestreo = Muestreo::QMC;
+            if (total_aprueba > 0) {
+                reporte.error_relativo = reporte.intervalo_general.semiancho() / t / general;
+            }
+            reporte.sensibilidades = sensibilidades;
         }
+        return reportes;
+    };
+
+    // Puntos por réplica en potencias de 2, donde la red de Sobol está balanceada
+    auto potencia_de_2 = [](int x) {
+        int p = 1;
+        while (p <= x / 2) p *= 2;
+        return p;
+    };
+
+    const int tope_por_replica = std::max(1, simulaciones / R);
+    int m = potencia_de_2(precision.has_value() ? std::min(TAM_BLOQUE_PRECISION / R, tope_por_replica)
+                                                : tope_por_replica);
+
+    // El tramo cuenta puntos de todas las réplicas. Entre tramos los puntos
+    // por réplica no son potencia de 2, pero la estimación parcial es válida.
+    const size_t tramo_replica = tramo > 0 ? std::max(ANCHO_BLOQUE, tramo / R / ANCHO_BLOQUE * ANCHO_BLOQUE) : 0;
+    int hechos = 0;
+    while (hechos < m) {
+        const int fin = tramo_replica > 0 ? static_cast<int>(std::min<size_t>(m, hechos + tramo_replica)) : m;
+        simular(static_cast<size_t>(hechos), static_cast<size_t>(fin));
+        hechos = fin;
+        if (hechos < m) co_yield armar_reportes(hechos);
     }
 
-    // 1. Probabilidad general de aprobar (sin considerar plan)
-    reporte.probabilidad_general = static_cast<double>(veces_aprueba) / simulaciones;
-    
-    // 2. Probabilidad de lograr el plan Y aprobar
-    reporte.probabilidad_del_plan = static_cast<double>(veces_logra_plan_y_aprueba) / simulaciones;
-    
-    // 3. Viabilidad: P(cumplió plan | aprobó)
-    if (veces_aprueba > 0) {
-        reporte.viabilidad = static_cast<double>(veces_aprueba_con_plan) / veces_aprueba;
-    } else {
-        reporte.viabilidad = 0.0;
+    if (precision.has_value()) {
+        // Duplicar los puntos de cada réplica hasta alcanzar la precisión
+        while (2 * m <= tope_por_replica) {
+            const auto reportes = armar_reportes(m);
+            double peor = 0.0;
+            for (const auto &reporte : reportes) {
+                peor = std::max({ peor, reporte.intervalo_general.semiancho(), reporte.intervalo_plan.semiancho(),
+                                  reporte.intervalo_viabilidad.semiancho() });
+            }
+            if (peor <= precision->semiancho) break;
+            co_yield reportes;
+
+            while (hechos < 2 * m) {
+                const int fin = tramo_replica > 0 ? static_cast<int>(std::min<size_t>(2 * m, hechos + tramo_replica))
+                                                  : 2 * m;
+                simular(static_cast<size_t>(hechos), static_cast<size_t>(fin));
+                hechos = fin;
+                if (hechos < 2 * m) co_yield armar_reportes(hechos);
+            }
+            m *= 2;
+        }
     }
 
-    return reporte;
+    co_return armar_reportes(m);
 }
 
-bool MaquinaP::validar_escenario(const std::map<std::string, double>& escenario,
-                                  const std::vector<Evaluacion>& evaluaciones,
-                                  const std::vector<Restriccion>& restricciones) {
-    // Promedio Ponderado Total
-    double total = 0.0;
-    for (const auto& eval : evaluaciones) {
-        total += escenario.at(eval.id) * eval.peso;
+namespace {
+
+// Punto de la región de aprobación cercano a la media del perfil, usado como
+// media de la propuesta del muestreo por importancia. Parte de la media
+// acotada al rango factible de cada pendiente (Máquina S) y proyecta
+// cíclicamente sobre cada restricción incumplida; todas son semiespacios
+// monótonos, así que basta subir notas pendientes.
+std::vector<double> punto_dominante(const CursoCompilado &curso, const EspacioSoluciones &espacio, double media) {
+    const auto &ctx = curso.ctx;
+    std::vector<double> x(curso.size());
+    curso.llenar_escenario(x, media);
+
+    std::vector<double> techo(curso.size(), ctx.nota_maxima);
+    for (int idx : curso.pendientes) {
+        auto it = espacio.rangos_por_evaluacion.find(curso.ids[idx]);
+        if (it == espacio.rangos_por_evaluacion.end()) continue;
+        techo[idx] = it->second.max_posible;
+        x[idx] = std::min(std::max(media, it->second.min_supervivencia), it->second.max_posible);
     }
-    if (total < ctx.nota_aprobacion) return false;
 
-    // Restricciones por Tag
-    for (const auto& res : restricciones) {
-        if (!evaluar_restriccion(res, escenario, evaluaciones)) return false;
+    auto subir = [&](int idx, double nota) { x[idx] = std::min(std::max(x[idx], nota), techo[idx]); };
+
+    for (int iteracion = 0; iteracion < 100 && !validar_escenario(curso, x); ++iteracion) {
+        // Promedio ponderado: moverse en la dirección de los pesos
+        const double deficit = ctx.nota_aprobacion - promedio_ponderado(curso, x);
+        if (deficit > 0) {
+            double suma_cuadrados = 0.0;
+            for (int idx : curso.pendientes) suma_cuadrados += curso.pesos[idx] * curso.pesos[idx];
+            if (suma_cuadrados > 0) {
+                for (int idx : curso.pendientes) {
+                    subir(idx, x[idx] + deficit * curso.pesos[idx] / suma_cuadrados);
+                }
+            }
+        }
+
+        for (const auto &res : curso.restricciones) {
+            if (res.tipo == TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG) {
+                for (int m : res.miembros) if (!curso.es_conocida(m)) subir(m, res.valor_minimo);
+                continue;
+            }
+
+            // Promedio simple del tag: repartir lo que falta entre sus pendientes
+            if (res.miembros.empty()) continue;
+            double suma = 0.0;
+            int pendientes = 0;
+            for (int m : res.miembros) {
+                suma += x[m];
+                if (!curso.es_conocida(m)) pendientes++;
+            }
+            const double falta = res.valor_minimo * res.miembros.size() - suma;
+            if (falta > 0 && pendientes > 0) {
+                for (int m : res.miembros) if (!curso.es_conocida(m)) subir(m, x[m] + falta / pendientes);
+            }
+        }
     }
-    return true;
+
+    return x;
 }
 
-bool MaquinaP::evaluar_restriccion(const Restriccion& res,
-                                    const std::map<std::string, double>& escenario,
-                                    const std::vector<Evaluacion>& evaluaciones) {
-    std::vector<double> notas;
-    std::vector<double> pesos;
+} // namespace
 
-    for (const auto& eval : evaluaciones) {
-        if (std::find(eval.tags.begin(), eval.tags.end(), res.tag_objetivo) != eval.tags.end()) {
-            notas.push_back(escenario.at(eval.id));
-            pesos.push_back(eval.peso);
+AnalisisPorTramos
+    MaquinaP::analizar_importancia(const EspacioSoluciones &espacio, const CursoCompilado &curso,
+                               const DatosBloque &datos, int simulaciones,
+                               std::optional<PrecisionObjetivo> precision, size_t tramo) {
+    const size_t n = curso.size();
+    const size_t k = datos.planes;
+    const size_t columnas = 2 + 2 * k;  // Σw, Σw² generales y por plan
+    const std::vector<double> medias = punto_dominante(curso, espacio, datos.media);
+
+    // Sumas por bloque de ANCHO_BLOQUE escenarios; se combinan en orden de
+    // bloque, así que el resultado no depende de la cantidad de hilos
+    std::vector<double> sumas_bloque;
+    PuntajesPorBloque puntajes(curso.pendientes.size());
+
+    auto simular = [&](size_t desde, size_t hasta) {
+        const size_t primer_bloque = desde / ANCHO_BLOQUE;
+        const size_t bloques = (hasta - desde + ANCHO_BLOQUE - 1) / ANCHO_BLOQUE;
+        sumas_bloque.resize((primer_bloque + bloques) * columnas, 0.0);
+        puntajes.nueva_tanda(bloques);
+
+        ejecutar_en_paralelo(bloques, hilos, MIN_BLOQUES_POR_HILO, [&](size_t inicio, size_t fin) {
+            std::vector<double> notas(n * ANCHO_BLOQUE);
+            std::vector<double> normales(curso.pendientes.size() * ANCHO_BLOQUE);
+            preparar_bloque(curso, notas.data());
+            EvaluadorEscenarios evaluador(curso);
+
+            for (size_t b = inicio; b < fin; ++b) {
+                const size_t primero = (primer_bloque + b) * ANCHO_BLOQUE;
+                const size_t ancho = std::min(ANCHO_BLOQUE, hasta - primero);
+                const PuntajesBloque puntajes_bloque { normales.data(), puntajes.sumas(b) };
+                simular_bloque_importancia(datos, evaluador, medias.data(), primero, ancho, notas.data(),
+                                           sumas_bloque.data() + (primer_bloque + b) * columnas, &puntajes_bloque);
+            }
+        });
+        puntajes.acumular_tanda();
+    };
+
+    const double confianza = precision.has_value() ? precision->confianza : 0.95;
+    const double z = z_confianza(confianza);
+
+    auto armar_reportes = [&](int usadas) {
+        std::vector<double> total(columnas, 0.0);
+        for (size_t b = 0; b * columnas < sumas_bloque.size(); ++b) {
+            for (size_t c = 0; c < columnas; ++c) total[c] += sumas_bloque[b * columnas + c];
         }
-    }
 
-    if (notas.empty()) return true;
+        const double N = static_cast<double>(usadas);
+        auto intervalo = [&](double estimado, double error) {
+            return IntervaloConfianza { std::max(0.0, estimado - z * error), std::min(1.0, estimado + z * error) };
+        };
+
+        // Estimador p = E[w·1], error estándar con el segundo momento
+        const double general = total[0] / N;
+        const double error_general = std::sqrt(std::max(0.0, total[1] / N - general * general) / N);
+        const auto sensibilidades = calcular_sensibilidades(curso, puntajes.total, N, general, datos.desviacion);
+
+        std::vector<ReporteProbabilidad> reportes(k);
+        for (size_t p = 0; p < k; ++p) {
+            auto &reporte = reportes[p];
+            const double plan = total[2 + 2 * p] / N;
+            const double error_plan = std::sqrt(std::max(0.0, total[3 + 2 * p] / N - plan * plan) / N);
+
+            reporte.probabilidad_general = general;
+            reporte.probabilidad_del_plan = plan;
+            reporte.viabilidad = general > 0 ? plan / general : 0.0;
+
+            // Viabilidad como razón (método delta): plan ⊂ aprueba
+            double error_viabilidad = 0.0;
+            if (general > 0) {
+                const double v = reporte.viabilidad;
+                const double m2_plan = total[3 + 2 * p] / N;
+                const double m2_resto = total[1] / N - m2_plan;
+                error_viabilidad = std::sqrt(std::max(0.0, m2_plan * (1 - v) * (1 - v) + m2_resto * v * v) / N) / general;
+            }
+
+            reporte.confianza = confianza;
+            // Sin aciertos el estimador no informa: se usa Wilson sobre 0 aciertos
+            reporte.intervalo_general = general > 0 ? intervalo(general, error_general)
+                                                    : intervalo_wilson(0, usadas, z);
+            reporte.intervalo_plan = plan > 0 ? intervalo(plan, error_plan) : intervalo_wilson(0, usadas, z);
+            reporte.intervalo_viabilidad = plan > 0 ? intervalo(reporte.viabilidad, error_viabilidad)
+                                                    : intervalo_wilson(0, usadas, z);
+            reporte.simulaciones_usadas = usadas;
+            reporte.muestreo = Muestreo::IMPORTANCIA;
+            if (general > 0) reporte.error_relativo = error_general / general;
+            reporte.sensibilidades = sensibilidades;
+        }
+        return reportes;
+    };
+
+    const int tope = std::max(simulaciones, 0);
+
+    // Simula hasta `hasta` de a tramos (múltiplos de ANCHO_BLOQUE)
+    int usadas = 0;
+    auto siguiente_tramo = [&](int hasta) {
+        return tramo > 0 ? static_cast<int>(std::min<size_t>(hasta, usadas + tramo)) : hasta;
+    };
 
-    if (res.tipo == TipoRestriccion::PROMEDIO_SIMPLE_TAG) {
-        double suma = 0;
-        for (double n : notas) suma += n;
-        return (suma / notas.size()) >= res.valor_minimo;
+    if (!precision.has_value()) {
+        while (usadas < tope) {
+            const int fin = siguiente_tramo(tope);
+            simular(static_cast<size_t>(usadas), static_cast<size_t>(fin));
+            usadas = fin;
+            if (usadas < tope) co_yield armar_reportes(usadas);
+        }
+        co_return armar_reportes(tope);
     }
-    else if (res.tipo == TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG) {
-        for (double n : notas) if (n < res.valor_minimo) return false;
-        return true;
+
+    // Mismo calendario que Monte Carlo: el siguiente bloque se estima con el
+    // semiancho actual, entre un bloque mínimo y duplicar lo simulado
+    int bloque = std::min(TAM_BLOQUE_PRECISION, tope);
+    while (true) {
+        const int fin_bloque = usadas + bloque;
+        while (usadas < fin_bloque) {
+            const int fin = siguiente_tramo(fin_bloque);
+            simular(static_cast<size_t>(usadas), static_cast<size_t>(fin));
+            usadas = fin;
+            if (usadas < fin_bloque) co_yield armar_reportes(usadas);
+        }
+
+        auto reportes = armar_reportes(usadas);
+        double peor = 0.0;
+        for (const auto &reporte : reportes) {
+            peor = std::max({ peor, reporte.intervalo_general.semiancho(), reporte.intervalo_plan.semiancho(),
+                              reporte.intervalo_viabilidad.semiancho() });
+        }
+        if (peor <= precision->semiancho || usadas >= tope) break;
+        co_yield std::move(reportes);
+
+        const double razon = peor / precision->semiancho;
+        const double siguiente = std::clamp(usadas * razon * razon - usadas,
+                                            static_cast<double>(TAM_BLOQUE_PRECISION), static_cast<double>(usadas));
+        // Múltiplo de ANCHO_BLOQUE para que los bloques no se partan
+        bloque = static_cast<int>(std::min(siguiente, static_cast<double>(tope - usadas)));
+        bloque -= bloque % static_cast<int>(ANCHO_BLOQUE);
+        if (bloque <= 0) bloque = tope - usadas;
     }
-    return true;
+    co_return armar_reportes(usadas);
 }
 
 double MaquinaP::calcular_probabilidad_base(
@@ -124,31 +646,35 @@ double MaquinaP::calcular_probabilidad_base(
     const std::vector<Restriccion>& restricciones,
     const PerfilEstadistico& perfil,
     int simulaciones) {
+    return calcular_probabilidad_base(compilar_curso(ctx, evaluaciones, restricciones), perfil, simulaciones);
+}
+
+double MaquinaP::calcular_probabilidad_base(
+    const CursoCompilado& curso,
+    const PerfilEstadistico& perfil,
+    int simulaciones) {
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::normal_distribution<double> dist(perfil.media_historica, perfil.desviacion_estandar);
+    const GeneradorContador generador(semilla.value_or(semilla_aleatoria()));
+    std::atomic<int> exitos { 0 };
 
-    int exitos = 0;
+    const DatosBloque datos { &curso, &generador, perfil.media_historica, perfil.desviacion_estandar,
+                              ctx.nota_minima, ctx.nota_maxima, nullptr, 0 };
 
-    for (int i = 0; i < simulaciones; ++i) {
-        std::map<std::string, double> escenario;
+    ejecutar_en_paralelo(static_cast<size_t>(std::max(simulaciones, 0)), hilos, MIN_SIMULACIONES_POR_HILO,
+                         [&](size_t inicio, size_t fin) {
+        int exitos_local = 0;
 
-        for (const auto& eval : evaluaciones) {
-            if (eval.valor_actual.has_value()) {
-                escenario[eval.id] = *eval.valor_actual;
-            } else {
-                // Generar nota según perfil y clampear a la escala
-                double nota_simulada = std::clamp(dist(gen), ctx.nota_minima, ctx.nota_maxima);
-                escenario[eval.id] = nota_simulada;
-            }
-        }
+        std::vector<double> notas(curso.size() * ANCHO_BLOQUE);
+        preparar_bloque(curso, notas.data());
+        EvaluadorEscenarios evaluador(curso);
 
-        // ¿Pasaría el ramo con este escenario aleatorio?
-        if (validar_escenario(escenario, evaluaciones, restricciones)) {
-            exitos++;
+        // ¿Pasaría el ramo con cada escenario aleatorio del bloque?
+        for (size_t i = inicio; i < fin; i += ANCHO_BLOQUE) {
+            simular_bloque(datos, evaluador, i, std::min(ANCHO_BLOQUE, fin - i), notas.data(), exitos_local, nullptr);
         }
-    }
+
+        exitos += exitos_local;
+    });
 
     return static_cast<double>(exitos) / simulaciones;
 }
@@ -1,5 +1,24 @@
+#pragma once
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
 #include "interface_s.hpp"
 #include "interface_d.hpp"
+#include "estadistica.hpp"
+
+// Cómo se sortean los escenarios
+enum class Muestreo {
+    MONTE_CARLO,  // Pseudoaleatorio
+    QMC,          // Sobol revuelto (cuasi Monte Carlo), con réplicas para estimar el error
+    IMPORTANCIA   // Desplazado hacia la región de aprobación y reponderado (eventos raros)
+};
 
 struct ReporteProbabilidad {
     // Probabilidad de aprobar el ramo según tu perfil histórico (sin considerar plan)
@@ -12,11 +31,94 @@ struct ReporteProbabilidad {
     // Dado que aprobaste, probabilidad de que haya sido cumpliendo el plan
     // P(cumplió plan | aprobó) - Mide si el plan es necesario o solo ayuda
     double viabilidad;
+
+    // Intervalos de confianza (Wilson) de las tres probabilidades
+    double confianza = 0.95;
+    IntervaloConfianza intervalo_general;
+    IntervaloConfianza intervalo_plan;
+    IntervaloConfianza intervalo_viabilidad;
+
+    // Escenarios simulados realmente (menos que el tope si se alcanzó la precisión)
+    int simulaciones_usadas = 0;
+
+    // Muestreo realmente usado (QMC cae a Monte Carlo con demasiadas
+    // pendientes o menos simulaciones que réplicas)
+    Muestreo muestreo = Muestreo::MONTE_CARLO;
+
+    // Error estándar relativo de probabilidad_general (NaN si es 0)
+    double error_relativo = std::numeric_limits<double>::quiet_NaN();
+
+    // ∂P(aprobar)/∂(media de la evaluación), por evaluación pendiente: cuánto
+    // sube la probabilidad general por cada punto que suba el rendimiento
+    // esperado en esa evaluación. Sale de los mismos escenarios (razón de
+    // verosimilitud), sin simulaciones extra.
+    std::map<std::string, double> sensibilidades;
+};
+
+// Modo de precisión: se simula por bloques hasta que los intervalos de las
+// tres probabilidades de todos los planes tengan semiancho <= `semiancho`,
+// con `simulaciones` como tope
+struct PrecisionObjetivo {
+    double semiancho;
+    double confianza = 0.95;
+};
+
+struct DatosBloque;
+
+// Análisis de la Máquina P que se ejecuta de a tramos (corrutina). Cada
+// avanzar() simula un tramo y deja en reportes() las estimaciones con lo
+// simulado hasta ahí; cuando devuelve false los reportes son los finales.
+// Para cancelar basta con dejar de avanzar y destruirlo.
+class AnalisisPorTramos {
+public:
+    struct promise_type {
+        std::vector<ReporteProbabilidad> reportes;
+        std::exception_ptr error;
+
+        AnalisisPorTramos get_return_object() { return AnalisisPorTramos(Corrutina::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(std::vector<ReporteProbabilidad> parciales) {
+            reportes = std::move(parciales);
+            return {};
+        }
+        void return_value(std::vector<ReporteProbabilidad> finales) { reportes = std::move(finales); }
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+    using Corrutina = std::coroutine_handle<promise_type>;
+
+    AnalisisPorTramos(AnalisisPorTramos&& otro) noexcept : corrutina(std::exchange(otro.corrutina, {})) {}
+    AnalisisPorTramos& operator=(AnalisisPorTramos&& otro) noexcept {
+        if (this != &otro) {
+            if (corrutina) corrutina.destroy();
+            corrutina = std::exchange(otro.corrutina, {});
+        }
+        return *this;
+    }
+    ~AnalisisPorTramos() { if (corrutina) corrutina.destroy(); }
+
+    // Simula el siguiente tramo; false cuando ya no quedan
+    bool avanzar() {
+        if (terminado()) return false;
+        corrutina.resume();
+        if (auto error = std::exchange(corrutina.promise().error, nullptr)) std::rethrow_exception(error);
+        return !corrutina.done();
+    }
+
+    bool terminado() const { return !corrutina || corrutina.done(); }
+    const std::vector<ReporteProbabilidad>& reportes() const { return corrutina.promise().reportes; }
+    std::vector<ReporteProbabilidad> tomar_reportes() { return std::move(corrutina.promise().reportes); }
+
+private:
+    explicit AnalisisPorTramos(Corrutina corrutina) : corrutina(corrutina) {}
+    Corrutina corrutina;
 };
 
 class MaquinaP {
 public:
-    MaquinaP(const Contexto& contexto);
+    // Con `semilla` los resultados son reproducibles y no dependen de `hilos`;
+    // sin ella cada llamada usa una semilla nueva
+    MaquinaP(const Contexto& contexto, std::optional<uint64_t> semilla = std::nullopt, int hilos = 1);
 
     // Punto de entrada: Analiza el riesgo y las probabilidades
     ReporteProbabilidad analizar(
@@ -36,15 +138,79 @@ public:
         int simulaciones = 50000
     );
 
+    // Variantes sobre un curso ya compilado
+    ReporteProbabilidad analizar(
+        const EspacioSoluciones& espacio,
+        const Sugerencias& plan,
+        const CursoCompilado& curso,
+        const PerfilEstadistico& perfil,
+        int simulaciones = 50000
+    );
+
+    // Analiza varios planes con una sola pasada: cada escenario se sortea y
+    // valida una vez y se contrasta con todos los planes. Un reporte por plan,
+    // en el mismo orden.
+    std::vector<ReporteProbabilidad> analizar_planes(
+        const EspacioSoluciones& espacio,
+        std::span<const Sugerencias> planes,
+        const CursoCompilado& curso,
+        const PerfilEstadistico& perfil,
+        int simulaciones = 50000,
+        const std::optional<PrecisionObjetivo>& precision = std::nullopt,
+        Muestreo muestreo = Muestreo::MONTE_CARLO
+    );
+
+    // Lo mismo que analizar_planes, de a `simulaciones_por_tramo` escenarios
+    // (redondeado a bloques de ANCHO_BLOQUE; 0 = todo en un tramo). Con
+    // semilla el resultado final es el mismo que sin tramos. `espacio`,
+    // `planes`, `curso` y la máquina deben vivir hasta que termine.
+    AnalisisPorTramos analizar_por_tramos(
+        const EspacioSoluciones& espacio,
+        std::span<const Sugerencias> planes,
+        const CursoCompilado& curso,
+        PerfilEstadistico perfil,
+        int simulaciones,
+        std::optional<PrecisionObjetivo> precision,
+        Muestreo muestreo,
+        int simulaciones_por_tramo
+    );
+
+    double calcular_probabilidad_base(
+        const CursoCompilado& curso,
+        const PerfilEstadistico& perfil,
+        int simulaciones = 50000
+    );
+
 private:
     Contexto ctx;
+    std::optional<uint64_t> semilla;
+    int hilos;
+
+    // Mínimo de escenarios por hilo antes de repartir
+    static constexpr size_t MIN_SIMULACIONES_POR_HILO = 2048;
+    static constexpr size_t MIN_BLOQUES_POR_HILO = MIN_SIMULACIONES_POR_HILO / ANCHO_BLOQUE;
 
-    // Reutilizamos la lógica de validación (podría estar en una clase base o utility)
-    bool validar_escenario(const std::map<std::string, double>& escenario,
-                          const std::vector<Evaluacion>& evaluaciones,
-                          const std::vector<Restriccion>& restricciones);
+    // Tamaño mínimo de bloque en el modo de precisión. El calendario de
+    // bloques solo depende de los conteos, no de la cantidad de hilos.
+    static constexpr int TAM_BLOQUE_PRECISION = 4096;
 
-    bool evaluar_restriccion(const Restriccion& res,
-                            const std::map<std::string, double>& escenario,
-                            const std::vector<Evaluacion>& evaluaciones);
+    // QMC: réplicas revueltas independientes; el error sale de su dispersión
+    static constexpr int REPLICAS_QMC = 16;
+
+    AnalisisPorTramos analizar_importancia(
+        const EspacioSoluciones& espacio,
+        const CursoCompilado& curso,
+        const DatosBloque& datos,
+        int simulaciones,
+        std::optional<PrecisionObjetivo> precision,
+        size_t tramo
+    );
+
+    AnalisisPorTramos analizar_qmc(
+        const CursoCompilado& curso,
+        const DatosBloque& datos,
+        int simulaciones,
+        std::optional<PrecisionObjetivo> precision,
+        size_t tramo
+    );
 };
@@ -0,0 +1,193 @@
+#include "kernel_bloques.hpp"
+#include <algorithm>
+#include "estadistica.hpp"
+
+// Versiones por conjunto de instrucciones con selección en tiempo de
+// ejecución (ifunc); donde no hay soporte queda una sola versión. En WASM
+// la versión vectorial es una build aparte (GRADESOLVER_WASM_VARIANTE) y el
+// loader de JavaScript elige cuál cargar.
+#if defined(__x86_64__) && defined(__linux__) && (defined(__GNUC__) || defined(__clang__)) && !defined(__EMSCRIPTEN__)
+#define GRADESOLVER_MULTIVERSION __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define GRADESOLVER_MULTIVERSION
+#endif
+
+void preparar_bloque(const CursoCompilado& curso, double* notas) {
+    for (size_t i = 0; i < curso.size(); ++i) {
+        std::fill_n(notas + i * ANCHO_BLOQUE, ANCHO_BLOQUE,
+                    curso.es_conocida(static_cast<int>(i)) ? curso.notas_conocidas[i] : 0.0);
+    }
+}
+
+namespace {
+
+// Valida el bloque ya generado y, por cada plan, marca en `cumple` los
+// escenarios que aprueban cumpliendo el plan y se lo pasa a `por_plan`.
+// Devuelve cuántos escenarios aprueban.
+template <typename PorPlan>
+inline size_t marcar_bloque(const DatosBloque& datos, EvaluadorEscenarios& evaluador,
+                            size_t ancho, const double* notas, uint8_t* vivo, PorPlan&& por_plan) {
+    const CursoCompilado& curso = *datos.curso;
+
+    // Validar el bloque; si nadie aprueba, ningún plan cuenta
+    const size_t aprobados = evaluador.validar_bloque(notas, ancho, vivo);
+    if (aprobados == 0) return 0;
+
+    // ¿Las notas simuladas cumplen o superan cada plan?
+    for (size_t p = 0; p < datos.planes; ++p) {
+        const double* objetivo_plan = datos.objetivo + p * curso.size();
+        uint8_t cumple[ANCHO_BLOQUE];
+        for (size_t j = 0; j < ancho; ++j) cumple[j] = vivo[j];
+
+        for (int idx : curso.pendientes) {
+            const double objetivo = objetivo_plan[idx];
+            if (std::isnan(objetivo)) continue;
+            const double* fila = notas + idx * ANCHO_BLOQUE;
+            for (size_t j = 0; j < ancho; ++j) cumple[j] &= !(fila[j] < objetivo);
+        }
+
+        por_plan(p, cumple);
+    }
+    return aprobados;
+}
+
+// Suma los puntajes del bloque; `peso` nulo equivale a pesos 1
+inline void sumar_puntajes(const PuntajesBloque& puntajes, size_t pendientes, size_t ancho,
+                           const uint8_t* vivo, const double* peso) {
+    for (size_t d = 0; d < pendientes; ++d) {
+        const double* s = puntajes.normales + d * ANCHO_BLOQUE;
+        double aprueba = 0.0, todos = 0.0;
+        for (size_t j = 0; j < ancho; ++j) {
+            const double v = peso ? peso[j] * s[j] : s[j];
+            todos += v;
+            aprueba += vivo[j] ? v : 0.0;
+        }
+        puntajes.sumas[2 * d] += aprueba;
+        puntajes.sumas[2 * d + 1] += todos;
+    }
+}
+
+// Valida el bloque ya generado y cuenta los planes cumplidos
+inline void contar_bloque(const DatosBloque& datos, EvaluadorEscenarios& evaluador,
+                          size_t ancho, const double* notas,
+                          int& aprueba, int* plan_y_aprueba, const PuntajesBloque* puntajes) {
+    uint8_t vivo[ANCHO_BLOQUE];
+    aprueba += static_cast<int>(marcar_bloque(datos, evaluador, ancho, notas, vivo,
+                                              [&](size_t p, const uint8_t* cumple) {
+        int total = 0;
+        for (size_t j = 0; j < ancho; ++j) total += cumple[j];
+        plan_y_aprueba[p] += total;
+    }));
+    if (puntajes) sumar_puntajes(*puntajes, datos.curso->pendientes.size(), ancho, vivo, nullptr);
+}
+
+} // namespace
+
+GRADESOLVER_MULTIVERSION
+void simular_bloque(const DatosBloque& datos, EvaluadorEscenarios& evaluador,
+                    uint64_t primero, size_t ancho, double* notas,
+                    int& aprueba, int* plan_y_aprueba, const PuntajesBloque* puntajes) {
+    // Clave del flujo aleatorio de cada escenario del bloque
+    uint64_t flujos[ANCHO_BLOQUE];
+    for (size_t j = 0; j < ancho; ++j) flujos[j] = datos.generador->flujo(primero + j);
+
+    // Generar notas aleatorias según perfil, una evaluación pendiente a la vez
+    int d = 0;
+    for (int idx : datos.curso->pendientes) {
+        double* fila = notas + idx * ANCHO_BLOQUE;
+        double* normales = puntajes ? puntajes->normales + d * ANCHO_BLOQUE : nullptr;
+        const uint64_t contador = static_cast<uint64_t>(idx);
+        for (size_t j = 0; j < ancho; ++j) {
+            const double z = GeneradorContador::normal(flujos[j], contador);
+            if (normales) normales[j] = z;
+            fila[j] = std::clamp(datos.media + datos.desviacion * z, datos.nota_minima, datos.nota_maxima);
+        }
+        ++d;
+    }
+
+    contar_bloque(datos, evaluador, ancho, notas, aprueba, plan_y_aprueba, puntajes);
+}
+
+void simular_bloque_sobol(const DatosBloque& datos, EvaluadorEscenarios& evaluador,
+                          const SecuenciaSobol& sobol, const uint32_t* semillas,
+                          uint64_t primero, size_t ancho, double* notas,
+                          int& aprueba, int* plan_y_aprueba, const PuntajesBloque* puntajes) {
+    // Cada coordenada revuelta pasa por la inversa de la normal; el +0.5
+    // centra el punto en su celda de 2^-32 y evita 0 y 1
+    int d = 0;
+    for (int idx : datos.curso->pendientes) {
+        double* fila = notas + idx * ANCHO_BLOQUE;
+        double* normales = puntajes ? puntajes->normales + d * ANCHO_BLOQUE : nullptr;
+        for (size_t j = 0; j < ancho; ++j) {
+            const uint32_t x = revolver_owen(sobol.punto(primero + j, d), semillas[d]);
+            const double z = cuantil_normal((static_cast<double>(x) + 0.5) * 0x1.0p-32);
+            if (normales) normales[j] = z;
+            fila[j] = std::clamp(datos.media + datos.desviacion * z, datos.nota_minima, datos.nota_maxima);
+        }
+        ++d;
+    }
+
+    contar_bloque(datos, evaluador, ancho, notas, aprueba, plan_y_aprueba, puntajes);
+}
+
+GRADESOLVER_MULTIVERSION
+void simular_bloque_importancia(const DatosBloque& datos, EvaluadorEscenarios& evaluador,
+                                const double* medias, uint64_t primero, size_t ancho,
+                                double* notas, double* sumas, const PuntajesBloque* puntajes) {
+    const CursoCompilado& curso = *datos.curso;
+
+    uint64_t flujos[ANCHO_BLOQUE];
+    for (size_t j = 0; j < ancho; ++j) flujos[j] = datos.generador->flujo(primero + j);
+
+    // Notas desde la propuesta N(medias[idx], desviacion) y log de la razón
+    // de verosimilitud perfil / propuesta, sobre la normal antes de acotar
+    double log_razon[ANCHO_BLOQUE] = {};
+    const double inv_2var = 1.0 / (2.0 * datos.desviacion * datos.desviacion);
+    const double inv_desviacion = 1.0 / datos.desviacion;
+    int d = 0;
+    for (int idx : curso.pendientes) {
+        double* fila = notas + idx * ANCHO_BLOQUE;
+        double* normales = puntajes ? puntajes->normales + d * ANCHO_BLOQUE : nullptr;
+        ++d;
+        const uint64_t contador = static_cast<uint64_t>(idx);
+        const double media_propuesta = medias[idx];
+        for (size_t j = 0; j < ancho; ++j) {
+            const double z = GeneradorContador::normal(flujos[j], contador);
+            const double x = media_propuesta + datos.desviacion * z;
+            const double d_perfil = x - datos.media;
+            const double d_propuesta = x - media_propuesta;
+            log_razon[j] += (d_propuesta * d_propuesta - d_perfil * d_perfil) * inv_2var;
+            if (normales) normales[j] = d_perfil * inv_desviacion;
+            fila[j] = std::clamp(x, datos.nota_minima, datos.nota_maxima);
+        }
+    }
+
+    double peso[ANCHO_BLOQUE];
+    for (size_t j = 0; j < ancho; ++j) peso[j] = std::exp(log_razon[j]);
+
+    // Sumas de w y w^2 sobre los que aprueban y, por plan, sobre los que
+    // aprueban cumpliéndolo (en orden de escenario: deterministas)
+    uint8_t vivo[ANCHO_BLOQUE];
+    const size_t aprobados = marcar_bloque(datos, evaluador, ancho, notas, vivo,
+                                           [&](size_t p, const uint8_t* cumple) {
+        double w = 0.0, w2 = 0.0;
+        for (size_t j = 0; j < ancho; ++j) {
+            const double v = cumple[j] ? peso[j] : 0.0;
+            w += v;
+            w2 += v * v;
+        }
+        sumas[2 + 2 * p] += w;
+        sumas[3 + 2 * p] += w2;
+    });
+
+    if (puntajes) sumar_puntajes(*puntajes, curso.pendientes.size(), ancho, vivo, peso);
+    if (aprobados == 0) return;
+    double w = 0.0, w2 = 0.0;
+    for (size_t j = 0; j < ancho; ++j) {
+        const double v = vivo[j] ? peso[j] : 0.0;
+        w += v;
+        w2 += v * v;
+    }
+    sumas[0] += w;
+    sumas[1] += w2;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "aleatorio.hpp"
+#include "evaluador.hpp"
+#include "sobol.hpp"
+
+// ============================================================================
+// NÚCLEO POR BLOQUES DE LA MÁQUINA P
+// ----------------------------------------------------------------------------
+// Simula hasta ANCHO_BLOQUE escenarios a la vez con las notas por columnas:
+// genera las normales de cada evaluación pendiente para todo el bloque,
+// las acota a la escala, valida el bloque y cuenta los planes cumplidos.
+// Se compila con varias versiones (AVX-512, AVX2, base) y se elige la del
+// procesador en tiempo de ejecución; todas dan exactamente el mismo resultado.
+// ============================================================================
+
+struct DatosBloque {
+    const CursoCompilado* curso;
+    const GeneradorContador* generador;
+    double media;
+    double desviacion;
+    double nota_minima;
+    double nota_maxima;
+
+    // Objetivo de cada plan por evaluación (fila por plan; NaN si no lo fija)
+    const double* objetivo;
+    size_t planes;
+};
+
+// Puntajes para las sensibilidades por razón de verosimilitud. Para la
+// d-ésima evaluación pendiente, con s = (x - media) / desviacion la normal
+// del perfil antes de acotar y w el peso del escenario (1 salvo en el
+// muestreo por importancia), se suman Σ w·s·1[aprueba] en sumas[2d] y Σ w·s
+// en sumas[2d + 1]. `normales` es espacio de trabajo de
+// pendientes * ANCHO_BLOQUE elementos.
+struct PuntajesBloque {
+    double* normales;
+    double* sumas;
+};
+
+// Simula los escenarios [primero, primero + ancho). `notas` tiene
+// curso.size() * ANCHO_BLOQUE elementos con las filas de las notas conocidas
+// ya llenas. Suma a `aprueba` y a `plan_y_aprueba[p]` los conteos del bloque
+// y, si `puntajes` no es nulo, los puntajes de las sensibilidades.
+void simular_bloque(const DatosBloque& datos, EvaluadorEscenarios& evaluador,
+                    uint64_t primero, size_t ancho, double* notas,
+                    int& aprueba, int* plan_y_aprueba,
+                    const PuntajesBloque* puntajes = nullptr);
+
+// Igual que simular_bloque pero con los puntos [primero, primero + ancho) de
+// una secuencia de Sobol revuelta: la dimensión d corresponde a la d-ésima
+// evaluación pendiente y `semillas[d]` es su revoltura en esta réplica
+void simular_bloque_sobol(const DatosBloque& datos, EvaluadorEscenarios& evaluador,
+                          const SecuenciaSobol& sobol, const uint32_t* semillas,
+                          uint64_t primero, size_t ancho, double* notas,
+                          int& aprueba, int* plan_y_aprueba,
+                          const PuntajesBloque* puntajes = nullptr);
+
+// Muestreo por importancia: las pendientes salen de N(medias[idx], desviacion)
+// y cada escenario pesa w = perfil / propuesta. Suma en `sumas` (2 + 2 *
+// planes elementos) Σw y Σw² de los que aprueban y, por plan, de los que
+// aprueban cumpliéndolo.
+void simular_bloque_importancia(const DatosBloque& datos, EvaluadorEscenarios& evaluador,
+                                const double* medias, uint64_t primero, size_t ancho,
+                                double* notas, double* sumas,
+                                const PuntajesBloque* puntajes = nullptr);
+
+// Llena las filas de las notas conocidas de un bloque
+void preparar_bloque(const CursoCompilado& curso, double* notas);
@@ -1,91 +1,76 @@
 #include "interface_s.hpp"
+#include "paralelo.hpp"
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
-MaquinaS::MaquinaS(const Contexto& contexto) : ctx(contexto) {}
+// Evaluaciones pendientes mínimas por hilo antes de repartir el trabajo
+constexpr size_t MIN_PENDIENTES_POR_HILO = 16;
+
+MaquinaS::MaquinaS(const Contexto& contexto, MetodoLimites metodo, int hilos)
+    : ctx(contexto), metodo(metodo), hilos(hilos) {}
 
 EspacioSoluciones MaquinaS::calcular_espacio(const std::vector<Evaluacion>& evaluaciones,
                                            const std::vector<Restriccion>& restricciones) {
+    return calcular_espacio(compilar_curso(ctx, evaluaciones, restricciones));
+}
+
+EspacioSoluciones MaquinaS::calcular_espacio(const CursoCompilado& curso) {
     EspacioSoluciones espacio;
 
+    // Buffer único de escenario, reutilizado por todas las validaciones
+    std::vector<double> escenario(curso.size());
+
     // 1. ¿Es físicamente posible pasar?
-    espacio.es_posible = caso_extremo_optimista(evaluaciones, restricciones);
+    espacio.es_posible = caso_extremo_optimista(curso, escenario);
 
     if (!espacio.es_posible) {
-        espacio.restricciones_incumplibles = identificar_criticas(evaluaciones, restricciones);
+        espacio.restricciones_incumplibles = identificar_criticas(curso, escenario);
         return espacio;
     }
 
-    // 2. Calcular límites para cada evaluación pendiente
-    for (const auto& eval : evaluaciones) {
-        if (!eval.valor_actual.has_value()) {
-            espacio.rangos_por_evaluacion[eval.id] = buscar_limites(eval.id, evaluaciones, restricciones);
-        }
+    // 2. Calcular límites para cada evaluación pendiente. Cada una es
+    // independiente: se reparten entre hilos, cada uno con su propio
+    // escenario, y el resultado se inserta en orden al final.
+    const auto& pendientes = curso.pendientes;
+    std::vector<RangoFactible> rangos(pendientes.size());
+
+    AgregadosCurso agregados;
+    int fallas_max = 0, fallas_aprobacion = 0;
+    if (metodo == MetodoLimites::EXACTO) {
+        agregados = AgregadosCurso::desde(curso);
+        fallas_max = agregados.contar_fallas(curso, ctx.nota_maxima);
+        fallas_aprobacion = agregados.contar_fallas(curso, ctx.nota_aprobacion);
     }
 
-    return espacio;
-}
-
-bool MaquinaS::validar_escenario(const std::map<std::string, double>& escenario,
-                                const std::vector<Evaluacion>& evaluaciones,
-                                const std::vector<Restriccion>& restricciones) {
-    // Promedio Ponderado Total
-    double total = 0.0;
-    for (const auto& eval : evaluaciones) {
-        total += escenario.at(eval.id) * eval.peso;
-    }
-    if (total < ctx.nota_aprobacion) return false;
-
-    // Restricciones por Tag
-    for (const auto& res : restricciones) {
-        if (!evaluar_restriccion(res, escenario, evaluaciones)) return false;
-    }
-    return true;
-}
-
-bool MaquinaS::evaluar_restriccion(const Restriccion& res,
-                                  const std::map<std::string, double>& escenario,
-                                  const std::vector<Evaluacion>& evaluaciones) {
-    std::vector<double> notas;
-    std::vector<double> pesos;
-
-    for (const auto& eval : evaluaciones) {
-        if (std::find(eval.tags.begin(), eval.tags.end(), res.tag_objetivo) != eval.tags.end()) {
-            notas.push_back(escenario.at(eval.id));
-            pesos.push_back(eval.peso);
+    ejecutar_en_paralelo(pendientes.size(), hilos, MIN_PENDIENTES_POR_HILO, [&](size_t inicio, size_t fin) {
+        std::vector<double> escenario_local(curso.size());
+        for (size_t p = inicio; p < fin; ++p) {
+            rangos[p] = metodo == MetodoLimites::BISECCION
+                ? buscar_limites(pendientes[p], curso, escenario_local)
+                : limites_exactos(pendientes[p], curso, agregados, fallas_max, fallas_aprobacion, escenario_local);
         }
-    }
+    });
 
-    if (notas.empty()) return true;
-
-    if (res.tipo == TipoRestriccion::PROMEDIO_SIMPLE_TAG) {
-        double suma = 0;
-        for (double n : notas) suma += n;
-        return (suma / notas.size()) >= res.valor_minimo;
-    }
-    else if (res.tipo == TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG) {
-        for (double n : notas) if (n < res.valor_minimo) return false;
-        return true;
+    for (size_t p = 0; p < pendientes.size(); ++p) {
+        espacio.rangos_por_evaluacion[curso.ids[pendientes[p]]] = rangos[p];
     }
-    return true;
+
+    return espacio;
 }
 
-bool MaquinaS::caso_extremo_optimista(const std::vector<Evaluacion>& evaluaciones,
-                                     const std::vector<Restriccion>& restricciones) {
-    std::map<std::string, double> escenario;
-    for (const auto& eval : evaluaciones) {
-        escenario[eval.id] = eval.valor_actual.value_or(ctx.nota_maxima);
-    }
-    return validar_escenario(escenario, evaluaciones, restricciones);
+bool MaquinaS::caso_extremo_optimista(const CursoCompilado& curso, std::span<double> escenario) {
+    curso.llenar_escenario(escenario, ctx.nota_maxima);
+    return validar_escenario(curso, escenario);
 }
 
-RangoFactible MaquinaS::buscar_limites(const std::string& id,
-                                     const std::vector<Evaluacion>& evaluaciones,
-                                     const std::vector<Restriccion>& restricciones) {
+RangoFactible MaquinaS::buscar_limites(int idx, const CursoCompilado& curso, std::span<double> escenario) const {
     // 1. Mínimo Supervivencia (Relleno con MAX)
+    curso.llenar_escenario(escenario, ctx.nota_maxima);
     double bot = ctx.nota_minima, top = ctx.nota_maxima, min_surv = ctx.nota_maxima;
     for (int i = 0; i < 15; i++) {
         double mid = bot + (top - bot) / 2.0;
-        if (puede_pasar(id, mid, evaluaciones, restricciones, ctx.nota_maxima)) {
+        if (puede_pasar(idx, mid, curso, escenario, ctx.nota_maxima)) {
             min_surv = mid; top = mid;
         } else {
             bot = mid;
@@ -93,11 +78,12 @@ RangoFactible MaquinaS::buscar_limites(const std::string& id,
     }
 
     // 2. Mínimo Seguridad (Relleno con APROBACION)
+    curso.llenar_escenario(escenario, ctx.nota_aprobacion);
     bot = ctx.nota_minima; top = ctx.nota_maxima;
     double min_sec = ctx.nota_maxima;
     for (int i = 0; i < 15; i++) {
         double mid = bot + (top - bot) / 2.0;
-        if (puede_pasar(id, mid, evaluaciones, restricciones, ctx.nota_aprobacion)) {
+        if (puede_pasar(idx, mid, curso, escenario, ctx.nota_aprobacion)) {
             min_sec = mid; top = mid;
         } else {
             bot = mid;
@@ -107,29 +93,56 @@ RangoFactible MaquinaS::buscar_limites(const std::string& id,
     return { min_surv, min_sec, ctx.nota_maxima };
 }
 
-bool MaquinaS::puede_pasar(const std::string& id, double val,
-                          const std::vector<Evaluacion>& evaluaciones,
-                          const std::vector<Restriccion>& restricciones,
-                          double fill_value) {
-    std::map<std::string, double> escenario;
-    for (const auto& eval : evaluaciones) {
-        escenario[eval.id] = (eval.id == id) ? val : eval.valor_actual.value_or(fill_value);
+RangoFactible MaquinaS::limites_exactos(int idx, const CursoCompilado& curso, const AgregadosCurso& agregados,
+                                        int fallas_max, int fallas_aprobacion, std::span<double> escenario) const {
+    auto resolver = [&](double relleno, int fallas) {
+        double limite = agregados.limite_inferior(curso, idx, relleno, fallas);
+
+        // Ninguna nota permite aprobar: mismo valor que entrega la bisección
+        if (!(limite <= ctx.nota_maxima)) return ctx.nota_maxima;
+
+        return ajustar_limite(idx, std::max(limite, ctx.nota_minima), curso, escenario, relleno);
+    };
+
+    double min_surv = resolver(ctx.nota_maxima, fallas_max);
+    double min_sec = resolver(ctx.nota_aprobacion, fallas_aprobacion);
+
+    return { min_surv, min_sec, ctx.nota_maxima };
+}
+
+double MaquinaS::ajustar_limite(int idx, double limite, const CursoCompilado& curso,
+                               std::span<double> escenario, double fill_value) const {
+    // El límite despejado puede diferir en el último dígito de la suma que hace
+    // validar_escenario (el error es relativo a la escala de notas, no al límite);
+    // se confirma sobre el escenario real y se corrige hacia arriba con pasos crecientes.
+    curso.llenar_escenario(escenario, fill_value);
+    double paso = std::numeric_limits<double>::epsilon() *
+                  std::max({ std::abs(ctx.nota_maxima), std::abs(ctx.nota_minima), std::abs(limite) });
+    for (int intento = 0; intento < 64 && limite <= ctx.nota_maxima; ++intento) {
+        if (puede_pasar(idx, limite, curso, escenario, fill_value)) return limite;
+        limite += paso;
+        paso *= 2.0;
     }
-    return validar_escenario(escenario, evaluaciones, restricciones);
+    return ctx.nota_maxima;
+}
+
+bool MaquinaS::puede_pasar(int idx, double val, const CursoCompilado& curso,
+                          std::span<double> escenario, double fill_value) const {
+    // El escenario ya viene relleno con fill_value; solo cambia la evaluación probada
+    escenario[idx] = val;
+    bool pasa = validar_escenario(curso, escenario);
+    escenario[idx] = fill_value;
+    return pasa;
 }
 
-std::vector<std::string> MaquinaS::identificar_criticas(const std::vector<Evaluacion>& evaluaciones,
-                                                     const std::vector<Restriccion>& restricciones) {
+std::vector<std::string> MaquinaS::identificar_criticas(const CursoCompilado& curso, std::span<double> escenario) {
     std::vector<std::string> criticas;
-    std::map<std::string, double> opt;
-    for (const auto& e : evaluaciones) opt[e.id] = e.valor_actual.value_or(ctx.nota_maxima);
+    curso.llenar_escenario(escenario, ctx.nota_maxima);
 
-    double total = 0.0;
-    for (const auto& e : evaluaciones) total += opt[e.id] * e.peso;
-    if (total < ctx.nota_aprobacion) criticas.push_back("GLOBAL_PASS_LIMIT");
+    if (promedio_ponderado(curso, escenario) < ctx.nota_aprobacion) criticas.push_back("GLOBAL_PASS_LIMIT");
 
-    for (const auto& res : restricciones) {
-        if (!evaluar_restriccion(res, opt, evaluaciones)) criticas.push_back(res.id);
+    for (size_t r = 0; r < curso.restricciones.size(); ++r) {
+        if (!evaluar_restriccion(curso.restricciones[r], escenario)) criticas.push_back(curso.ids_restricciones[r]);
     }
     return criticas;
 }
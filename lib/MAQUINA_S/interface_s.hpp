@@ -1,8 +1,10 @@
 #pragma once
 #include <map>
+#include <span>
 #include <string>
 #include <vector>
 #include "index.hpp"
+#include "evaluador.hpp"
 
 struct RangoFactible {
     double min_supervivencia; // Mínimo absoluto (relleno optimista con MAX)
@@ -16,37 +18,68 @@ struct EspacioSoluciones {
     std::vector<std::string> restricciones_incumplibles; // IDs de las que fallan en el mejor caso
 };
 
+// Método para calcular los límites de cada evaluación pendiente
+enum class MetodoLimites {
+    EXACTO,    // Forma cerrada sobre las restricciones lineales (por defecto)
+    BISECCION  // Búsqueda binaria de 15 pasos (referencia para pruebas diferenciales)
+};
+
+// Sumas parciales de las notas conocidas, globales y por restricción.
+// Con ellas cada límite se despeja sin recorrer todo el curso.
+struct AgregadosCurso {
+    double suma_ponderada_conocida = 0.0;
+    double peso_pendiente = 0.0;
+
+    // Por restricción (misma posición que CursoCompilado::restricciones)
+    std::vector<double> suma_conocida;       // Suma de notas conocidas de los miembros
+    std::vector<int> miembros_pendientes;    // Miembros aún sin nota
+    std::vector<int> conocidas_bajo_minimo;  // Miembros con nota conocida < valor_minimo
+
+    static AgregadosCurso desde(const CursoCompilado& curso);
+
+    // Actualizaciones O(tags de la evaluación)
+    void registrar_nota(const CursoCompilado& curso, int idx, double valor);
+    void retirar_nota(const CursoCompilado& curso, int idx, double valor);
+
+    // ¿La restricción r falla con las pendientes rellenas con `relleno`?
+    bool restriccion_falla(const CursoCompilado& curso, int r, double relleno) const;
+    int contar_fallas(const CursoCompilado& curso, double relleno) const;
+
+    // Menor nota de la evaluación pendiente `idx` que permite aprobar con el resto
+    // de pendientes en `relleno`. Devuelve +inf si ninguna nota lo permite.
+    // `fallas` es contar_fallas(curso, relleno).
+    double limite_inferior(const CursoCompilado& curso, int idx, double relleno, int fallas) const;
+};
+
 class MaquinaS {
 public:
-    MaquinaS(const Contexto& contexto);
+    // hilos: 0 = todos los núcleos, 1 = serial (en WASM sin pthreads siempre serial)
+    MaquinaS(const Contexto& contexto, MetodoLimites metodo = MetodoLimites::EXACTO, int hilos = 1);
 
     // Punto de entrada único: Calcula el espacio de soluciones
     EspacioSoluciones calcular_espacio(const std::vector<Evaluacion>& evaluaciones,
                                       const std::vector<Restriccion>& restricciones);
 
+    // Variante sobre un curso ya compilado (evita volver a internar ids y tags)
+    EspacioSoluciones calcular_espacio(const CursoCompilado& curso);
+
 private:
     Contexto ctx;
+    MetodoLimites metodo;
+    int hilos;
 
-    bool validar_escenario(const std::map<std::string, double>& escenario,
-                          const std::vector<Evaluacion>& evaluaciones,
-                          const std::vector<Restriccion>& restricciones);
+    bool caso_extremo_optimista(const CursoCompilado& curso, std::span<double> escenario);
 
-    bool evaluar_restriccion(const Restriccion& res,
-                            const std::map<std::string, double>& escenario,
-                            const std::vector<Evaluacion>& evaluaciones);
+    std::vector<std::string> identificar_criticas(const CursoCompilado& curso, std::span<double> escenario);
 
-    bool caso_extremo_optimista(const std::vector<Evaluacion>& evaluaciones,
-                               const std::vector<Restriccion>& restricciones);
+    RangoFactible buscar_limites(int idx, const CursoCompilado& curso, std::span<double> escenario) const;
 
-    std::vector<std::string> identificar_criticas(const std::vector<Evaluacion>& evaluaciones,
-                                                 const std::vector<Restriccion>& restricciones);
+    RangoFactible limites_exactos(int idx, const CursoCompilado& curso, const AgregadosCurso& agregados,
+                                  int fallas_max, int fallas_aprobacion, std::span<double> escenario) const;
 
-    RangoFactible buscar_limites(const std::string& id,
-                                const std::vector<Evaluacion>& evaluaciones,
-                                const std::vector<Restriccion>& restricciones);
+    double ajustar_limite(int idx, double limite, const CursoCompilado& curso,
+                          std::span<double> escenario, double fill_value) const;
 
-    bool puede_pasar(const std::string& id, double val,
-                    const std::vector<Evaluacion>& evaluaciones,
-                    const std::vector<Restriccion>& restricciones,
-                    double fill_value);
+    bool puede_pasar(int idx, double val, const CursoCompilado& curso,
+                    std::span<double> escenario, double fill_value) const;
 };
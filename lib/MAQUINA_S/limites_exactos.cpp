@@ -0,0 +1,131 @@
+#include "interface_s.hpp"
+#include <algorithm>
+#include <limits>
+
+// ============================================================================
+// LÍMITES EN FORMA CERRADA
+// ----------------------------------------------------------------------------
+// Todas las restricciones son lineales (promedio global ponderado,
+// PROMEDIO_SIMPLE_TAG) o de caja (NOTA_MINIMA_INDIVIDUAL_TAG), y todas son
+// monótonas en la nota de cada evaluación. Fijando el resto de pendientes en
+// un valor de relleno, cada restricción que contiene a la evaluación aporta
+// una cota inferior despejable; las que no la contienen se cumplen o no con
+// independencia de su nota.
+// ============================================================================
+
+AgregadosCurso AgregadosCurso::desde(const CursoCompilado& curso) {
+    AgregadosCurso agregados;
+
+    for (size_t i = 0; i < curso.size(); ++i) {
+        if (curso.es_conocida(static_cast<int>(i))) {
+            agregados.suma_ponderada_conocida += curso.notas_conocidas[i] * curso.pesos[i];
+        } else {
+            agregados.peso_pendiente += curso.pesos[i];
+        }
+    }
+
+    const size_t n_res = curso.restricciones.size();
+    agregados.suma_conocida.assign(n_res, 0.0);
+    agregados.miembros_pendientes.assign(n_res, 0);
+    agregados.conocidas_bajo_minimo.assign(n_res, 0);
+
+    for (size_t r = 0; r < n_res; ++r) {
+        const auto& res = curso.restricciones[r];
+        for (int m : res.miembros) {
+            if (curso.es_conocida(m)) {
+                agregados.suma_conocida[r] += curso.notas_conocidas[m];
+                if (curso.notas_conocidas[m] < res.valor_minimo) agregados.conocidas_bajo_minimo[r]++;
+            } else {
+                agregados.miembros_pendientes[r]++;
+            }
+        }
+    }
+
+    return agregados;
+}
+
+void AgregadosCurso::registrar_nota(const CursoCompilado& curso, int idx, double valor) {
+    suma_ponderada_conocida += valor * curso.pesos[idx];
+    peso_pendiente -= curso.pesos[idx];
+
+    for (int r : curso.restricciones_por_evaluacion[idx]) {
+        suma_conocida[r] += valor;
+        miembros_pendientes[r]--;
+        if (valor < curso.restricciones[r].valor_minimo) conocidas_bajo_minimo[r]++;
+    }
+}
+
+void AgregadosCurso::retirar_nota(const CursoCompilado& curso, int idx, double valor) {
+    suma_ponderada_conocida -= valor * curso.pesos[idx];
+    peso_pendiente += curso.pesos[idx];
+
+    for (int r : curso.restricciones_por_evaluacion[idx]) {
+        suma_conocida[r] -= valor;
+        miembros_pendientes[r]++;
+        if (valor < curso.restricciones[r].valor_minimo) conocidas_bajo_minimo[r]--;
+    }
+}
+
+bool AgregadosCurso::restriccion_falla(const CursoCompilado& curso, int r, double relleno) const {
+    const auto& res = curso.restricciones[r];
+    if (res.miembros.empty()) return false;
+
+    if (res.tipo == TipoRestriccion::PROMEDIO_SIMPLE_TAG) {
+        double suma = suma_conocida[r] + relleno * miembros_pendientes[r];
+        return (suma / res.miembros.size()) < res.valor_minimo;
+    }
+    else if (res.tipo == TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG) {
+        return conocidas_bajo_minimo[r] > 0 || (miembros_pendientes[r] > 0 && relleno < res.valor_minimo);
+    }
+    return false;
+}
+
+int AgregadosCurso::contar_fallas(const CursoCompilado& curso, double relleno) const {
+    int fallas = 0;
+    for (size_t r = 0; r < curso.restricciones.size(); ++r) {
+        if (restriccion_falla(curso, static_cast<int>(r), relleno)) fallas++;
+    }
+    return fallas;
+}
+
+double AgregadosCurso::limite_inferior(const CursoCompilado& curso, int idx, double relleno, int fallas) const {
+    constexpr double imposible = std::numeric_limits<double>::infinity();
+    const auto& propias = curso.restricciones_por_evaluacion[idx];
+
+    // Restricciones que no contienen a idx: deben cumplirse por sí solas
+    int fallas_propias = 0;
+    for (int r : propias) {
+        if (restriccion_falla(curso, r, relleno)) fallas_propias++;
+    }
+    if (fallas > fallas_propias) return imposible;
+
+    double limite = -std::numeric_limits<double>::infinity();
+
+    // Promedio ponderado global: resto + peso * v >= nota_aprobacion
+    const double peso = curso.pesos[idx];
+    const double resto = suma_ponderada_conocida + relleno * (peso_pendiente - peso);
+    if (peso > 0.0) {
+        limite = (curso.ctx.nota_aprobacion - resto) / peso;
+    } else if (resto < curso.ctx.nota_aprobacion) {
+        return imposible;
+    }
+
+    // Restricciones por tag que contienen a idx
+    for (int r : propias) {
+        const auto& res = curso.restricciones[r];
+
+        if (res.tipo == TipoRestriccion::PROMEDIO_SIMPLE_TAG) {
+            // (otros + v) / n >= valor_minimo
+            double otros = suma_conocida[r] + relleno * (miembros_pendientes[r] - 1);
+            limite = std::max(limite, res.valor_minimo * res.miembros.size() - otros);
+        }
+        else if (res.tipo == TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG) {
+            // El resto de miembros también debe cumplir el mínimo
+            if (conocidas_bajo_minimo[r] > 0) return imposible;
+            if (miembros_pendientes[r] > 1 && relleno < res.valor_minimo) return imposible;
+            limite = std::max(limite, res.valor_minimo);
+        }
+    }
+
+    return limite;
+}
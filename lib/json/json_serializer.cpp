@@ -1,5 +1,7 @@
 #include "json_serializer.hpp"
+#include <cmath>
 #include <fstream>
+#include <limits>
 #include <stdexcept>
 
 namespace GradeSolver {
@@ -29,34 +31,42 @@ TipoRestriccion string_to_tipo_restriccion(const std::string& str) {
     throw std::runtime_error("Tipo de restriccion desconocido: " + str);
 }
 
+// Los nombres de las estrategias son los del registro de la Máquina D
 std::string tipo_estrategia_to_string(TipoEstrategia tipo) {
-    switch (tipo) {
-        case TipoEstrategia::MINIMUM:
-            return "MINIMUM";
-        case TipoEstrategia::BALANCED:
-            return "BALANCED";
-        case TipoEstrategia::MAX_WEIGHT_FIRST:
-            return "MAX_WEIGHT_FIRST";
-        case TipoEstrategia::MIN_WEIGHT_FIRST:
-            return "MIN_WEIGHT_FIRST";
-        default:
-            throw std::runtime_error("TipoEstrategia desconocido");
-    }
+    return std::string(nombre_estrategia(tipo));
 }
 
 TipoEstrategia string_to_tipo_estrategia(const std::string& str) {
-    if (str == "MINIMUM") {
-        return TipoEstrategia::MINIMUM;
-    } else if (str == "BALANCED") {
-        return TipoEstrategia::BALANCED;
-    } else if (str == "MAX_WEIGHT_FIRST") {
-        return TipoEstrategia::MAX_WEIGHT_FIRST;
-    } else if (str == "MIN_WEIGHT_FIRST") {
-        return TipoEstrategia::MIN_WEIGHT_FIRST;
+    if (auto tipo = estrategia_por_nombre(str)) {
+        return *tipo;
     }
     throw std::runtime_error("Tipo de estrategia desconocido: " + str);
 }
 
+std::string muestreo_to_string(Muestreo muestreo) {
+    switch (muestreo) {
+        case Muestreo::MONTE_CARLO:
+            return "MC";
+        case Muestreo::QMC:
+            return "QMC";
+        case Muestreo::IMPORTANCIA:
+            return "IS";
+        default:
+            throw std::runtime_error("Muestreo desconocido");
+    }
+}
+
+Muestreo string_to_muestreo(const std::string& str) {
+    if (str == "MC") {
+        return Muestreo::MONTE_CARLO;
+    } else if (str == "QMC") {
+        return Muestreo::QMC;
+    } else if (str == "IS") {
+        return Muestreo::IMPORTANCIA;
+    }
+    throw std::runtime_error("Muestreo desconocido: " + str);
+}
+
 // ============================================================================
 // DESERIALIZACIÓN: JSON -> ESTRUCTURAS C++
 // ============================================================================
@@ -98,6 +108,12 @@ PerfilEstadistico parse_perfil_estadistico(const json& j) {
     PerfilEstadistico perfil;
     perfil.media_historica = j["media_historica"];
     perfil.desviacion_estandar = j["desviacion_estandar"];
+    // Desviación 0 es un perfil degenerado válido: todas las pendientes
+    // valen la media (el muestreo por importancia cae a Monte Carlo)
+    if (!std::isfinite(perfil.media_historica) || !(perfil.desviacion_estandar >= 0.0) ||
+        !std::isfinite(perfil.desviacion_estandar)) {
+        throw std::runtime_error("media_historica debe ser finita y desviacion_estandar finita y >= 0");
+    }
     return perfil;
 }
 
@@ -134,12 +150,42 @@ EntradaCompleta parse_entrada_completa(const json& j) {
         if (j["P"].contains("simulaciones")) {
             entrada.simulaciones = j["P"]["simulaciones"];
         }
+        if (j["P"].contains("semilla")) {
+            // get<uint64_t>() convierte sin avisar -1 a 2^64 - 1 y trunca 1.5.
+            // El parser deja los enteros >= 0 como unsigned; un json armado en
+            // C++ con un int positivo queda como entero con signo
+            const auto& semilla = j["P"]["semilla"];
+            if (!semilla.is_number_unsigned() && !(semilla.is_number_integer() && semilla.get<int64_t>() >= 0)) {
+                throw std::runtime_error("semilla debe ser un entero >= 0");
+            }
+            entrada.semilla = semilla.get<uint64_t>();
+        }
+        if (j["P"].contains("precision_objetivo")) {
+            PrecisionObjetivo precision;
+            precision.semiancho = j["P"]["precision_objetivo"];
+            if (j["P"].contains("confianza")) {
+                precision.confianza = j["P"]["confianza"];
+            }
+            if (!(precision.semiancho > 0.0) || !(precision.confianza > 0.0 && precision.confianza < 1.0)) {
+                throw std::runtime_error("precision_objetivo debe ser > 0 y confianza debe estar en (0, 1)");
+            }
+            entrada.precision = precision;
+        }
+        if (j["P"].contains("muestreo")) {
+            entrada.muestreo = string_to_muestreo(j["P"]["muestreo"]);
+        }
         if (j["P"].contains("media_historica") && j["P"].contains("desviacion_estandar")) {
-            PerfilEstadistico perfil;
-            perfil.media_historica = j["P"]["media_historica"];
-            perfil.desviacion_estandar = j["P"]["desviacion_estandar"];
-            entrada.perfil = perfil;
+            entrada.perfil = parse_perfil_estadistico(j["P"]);
+        }
+    }
+
+    // Parsear configuración opcional de Máquina D
+    if (j.contains("D") && j["D"].contains("puntos_frontera")) {
+        const int puntos = j["D"]["puntos_frontera"];
+        if (puntos < 0 || puntos > 1000) {
+            throw std::runtime_error("puntos_frontera debe estar entre 0 y 1000");
         }
+        entrada.puntos_frontera = puntos;
     }
 
     return entrada;
@@ -157,6 +203,34 @@ EntradaCompleta parse_entrada_from_file(const std::string& filepath) {
     return parse_entrada_completa(j);
 }
 
+EntradaCohorte parse_entrada_cohorte(const json& j) {
+    EntradaCohorte entrada;
+    entrada.curso = parse_entrada_completa(j);
+
+    if (!j.contains("cohorte") || !j["cohorte"].is_array()) {
+        throw std::runtime_error("Falta la matriz 'cohorte' con las notas por estudiante");
+    }
+
+    const size_t n = entrada.curso.evaluaciones.size();
+    const auto& filas = j["cohorte"];
+    entrada.estudiantes = filas.size();
+    entrada.notas.reserve(entrada.estudiantes * n);
+
+    for (size_t e = 0; e < filas.size(); ++e) {
+        const auto& fila = filas[e];
+        if (!fila.is_array() || fila.size() != n) {
+            throw std::runtime_error("La fila " + std::to_string(e) + " de 'cohorte' debe tener " +
+                                     std::to_string(n) + " notas");
+        }
+        for (const auto& nota : fila) {
+            entrada.notas.push_back(nota.is_null() ? std::numeric_limits<double>::quiet_NaN()
+                                                   : nota.get<double>());
+        }
+    }
+
+    return entrada;
+}
+
 // ============================================================================
 // SERIALIZACIÓN: ESTRUCTURAS C++ -> JSON
 // ============================================================================
@@ -235,20 +309,65 @@ json to_json(const Sugerencias& sugerencias) {
     }
     j["notas_objetivo"] = notas_json;
 
-    j["estrategia_aplicada"] = tipo_estrategia_to_string(sugerencias.estrategia_aplicada);
+    j["estrategia_aplicada"] = sugerencias.estrategia_aplicada.has_value()
+        ? json(tipo_estrategia_to_string(sugerencias.estrategia_aplicada.value()))
+        : json(nullptr);
     j["promedio_final_teorico"] = sugerencias.promedio_final_teorico;
 
     return j;
 }
 
+json to_json(const IntervaloConfianza& intervalo) {
+    return json{
+        {"inferior", intervalo.inferior},
+        {"superior", intervalo.superior}
+    };
+}
+
 json to_json(const ReporteProbabilidad& reporte) {
     return json{
         {"probabilidad_general", reporte.probabilidad_general},
         {"probabilidad_del_plan", reporte.probabilidad_del_plan},
-        {"viabilidad", reporte.viabilidad}
+        {"viabilidad", reporte.viabilidad},
+        {"intervalos", {
+            {"confianza", reporte.confianza},
+            {"probabilidad_general", to_json(reporte.intervalo_general)},
+            {"probabilidad_del_plan", to_json(reporte.intervalo_plan)},
+            {"viabilidad", to_json(reporte.intervalo_viabilidad)}
+        }},
+        {"simulaciones_usadas", reporte.simulaciones_usadas},
+        {"muestreo", muestreo_to_string(reporte.muestreo)},
+        // NaN (sin aprobaciones) sale como null
+        {"error_relativo", std::isnan(reporte.error_relativo) ? json(nullptr) : json(reporte.error_relativo)},
+        {"sensibilidades", reporte.sensibilidades}
+    };
+}
+
+json to_json(const PuntoFrontera& punto) {
+    return json{
+        {"nivel", punto.nivel},
+        {"notas_objetivo", punto.plan.notas_objetivo},
+        {"promedio_final_teorico", punto.plan.promedio_final_teorico},
+        {"probabilidad_del_plan", punto.reporte.probabilidad_del_plan},
+        {"viabilidad", punto.reporte.viabilidad},
+        {"intervalo_plan", to_json(punto.reporte.intervalo_plan)}
     };
 }
 
+namespace {
+
+// Frontera como arreglo; no se agrega a la salida si no se pidió
+void agregar_frontera(json& j, const std::vector<PuntoFrontera>& frontera) {
+    if (frontera.empty()) return;
+    json frontera_json = json::array();
+    for (const auto& punto : frontera) {
+        frontera_json.push_back(to_json(punto));
+    }
+    j["frontera"] = frontera_json;
+}
+
+} // namespace
+
 json to_json(const SalidaCompleta& salida) {
     json j;
 
@@ -286,6 +405,9 @@ json to_json(const SalidaCompleta& salida) {
     }
     j["maquina_p"] = reportes_json;
 
+    // Frontera esfuerzo/probabilidad (opcional)
+    agregar_frontera(j, salida.frontera);
+
     // Perfil usado (opcional)
     if (salida.perfil_usado.has_value()) {
         j["perfil_usado"] = to_json(salida.perfil_usado.value());
@@ -294,6 +416,30 @@ json to_json(const SalidaCompleta& salida) {
     return j;
 }
 
+json to_json(const ResultadoEstudiante& resultado) {
+    json j;
+    j["maquina_s"] = to_json(resultado.espacio_soluciones);
+
+    json planes_json = json::object();
+    for (const auto& [estrategia, plan] : resultado.planes) {
+        planes_json[estrategia] = to_json(plan);
+    }
+    j["maquina_d"] = planes_json;
+
+    json reportes_json = json::object();
+    for (const auto& [estrategia, reporte] : resultado.reportes_probabilidad) {
+        reportes_json[estrategia] = to_json(reporte);
+    }
+    j["maquina_p"] = reportes_json;
+    agregar_frontera(j, resultado.frontera);
+
+    if (resultado.perfil_usado.has_value()) {
+        j["perfil_usado"] = to_json(resultado.perfil_usado.value());
+    }
+
+    return j;
+}
+
 void save_to_file(const SalidaCompleta& salida, const std::string& filepath) {
     std::ofstream file(filepath);
     if (!file.is_open()) {
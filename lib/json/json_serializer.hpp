@@ -27,6 +27,9 @@ TipoRestriccion string_to_tipo_restriccion(const std::string& str);
 std::string tipo_estrategia_to_string(TipoEstrategia tipo);
 TipoEstrategia string_to_tipo_estrategia(const std::string& str);
 
+std::string muestreo_to_string(Muestreo muestreo);
+Muestreo string_to_muestreo(const std::string& str);
+
 // ============================================================================
 // DESERIALIZACIÓN: JSON -> ESTRUCTURAS C++
 // ============================================================================
@@ -46,11 +49,29 @@ struct EntradaCompleta {
     // Opcional: configuración para Máquina P
     std::optional<int> simulaciones;
     std::optional<PerfilEstadistico> perfil;
+    std::optional<uint64_t> semilla;  // Resultados reproducibles si se entrega
+    std::optional<PrecisionObjetivo> precision;  // Simular hasta esta precisión
+    std::optional<Muestreo> muestreo;            // "MC" (por defecto), "QMC" o "IS"
+
+    // Opcional: configuración para Máquina D
+    std::optional<int> puntos_frontera;          // Planes de la frontera esfuerzo/probabilidad
 };
 
 EntradaCompleta parse_entrada_completa(const json& j);
 EntradaCompleta parse_entrada_from_file(const std::string& filepath);
 
+// Entrada de cohorte: un curso y una matriz de notas por estudiante
+struct EntradaCohorte {
+    EntradaCompleta curso;
+
+    // Matriz fila-mayor [estudiante][evaluación], en el orden de
+    // curso.evaluaciones. NaN = pendiente.
+    size_t estudiantes = 0;
+    std::vector<double> notas;
+};
+
+EntradaCohorte parse_entrada_cohorte(const json& j);
+
 // ============================================================================
 // SERIALIZACIÓN: ESTRUCTURAS C++ -> JSON
 // ============================================================================
@@ -65,8 +86,19 @@ json to_json(const PerfilEstadistico& perfil);
 json to_json(const RangoFactible& rango);
 json to_json(const EspacioSoluciones& espacio);
 json to_json(const Sugerencias& sugerencias);
+json to_json(const IntervaloConfianza& intervalo);
 json to_json(const ReporteProbabilidad& reporte);
 
+// Punto de la frontera esfuerzo/probabilidad: plan de la familia paramétrica
+// de la Máquina D y su reporte de la Máquina P
+struct PuntoFrontera {
+    double nivel;
+    Sugerencias plan;
+    ReporteProbabilidad reporte;
+};
+
+json to_json(const PuntoFrontera& punto);
+
 // Estructura de salida completa
 struct SalidaCompleta {
     Contexto contexto;
@@ -82,11 +114,25 @@ struct SalidaCompleta {
     // Salida de Máquina P (para cada plan)
     std::map<std::string, ReporteProbabilidad> reportes_probabilidad;
 
+    // Frontera esfuerzo/probabilidad (vacía si no se pidió)
+    std::vector<PuntoFrontera> frontera;
+
     // Opcional: Perfil usado
     std::optional<PerfilEstadistico> perfil_usado;
 };
 
 json to_json(const SalidaCompleta& salida);
+
+// Resultado de un estudiante dentro de una cohorte (sin repetir el curso)
+struct ResultadoEstudiante {
+    EspacioSoluciones espacio_soluciones;
+    std::map<std::string, Sugerencias> planes;
+    std::map<std::string, ReporteProbabilidad> reportes_probabilidad;
+    std::vector<PuntoFrontera> frontera;
+    std::optional<PerfilEstadistico> perfil_usado;
+};
+
+json to_json(const ResultadoEstudiante& resultado);
 void save_to_file(const SalidaCompleta& salida, const std::string& filepath);
 
 // Función de conveniencia para serializar solo una sección
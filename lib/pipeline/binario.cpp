@@ -0,0 +1,190 @@
+#include "binario.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace GradeSolver {
+
+namespace {
+
+// Rechaza lo que el JSON nunca produciría: escala no finita o invertida,
+// pesos negativos o no finitos, notas fuera de la escala y mínimos no finitos
+void validar_entrada(const Contexto& ctx, const double* pesos, const double* notas, int32_t n,
+                     const double* minimos, int32_t r) {
+    if (!std::isfinite(ctx.nota_minima) || !std::isfinite(ctx.nota_maxima) || !std::isfinite(ctx.nota_aprobacion) ||
+        !(ctx.nota_minima < ctx.nota_maxima) || ctx.nota_aprobacion < ctx.nota_minima ||
+        ctx.nota_aprobacion > ctx.nota_maxima) {
+        throw std::runtime_error("Contexto invalido: se requiere nota_minima <= nota_aprobacion <= nota_maxima, "
+                                 "finitas y con nota_minima < nota_maxima");
+    }
+    for (int32_t i = 0; i < n; ++i) {
+        if (!std::isfinite(pesos[i]) || pesos[i] < 0.0) {
+            throw std::runtime_error("Peso invalido en la evaluacion " + std::to_string(i));
+        }
+        // NaN = pendiente
+        if (!std::isnan(notas[i]) && !(notas[i] >= ctx.nota_minima && notas[i] <= ctx.nota_maxima)) {
+            throw std::runtime_error("Nota fuera de la escala en la evaluacion " + std::to_string(i));
+        }
+    }
+    for (int32_t k = 0; k < r; ++k) {
+        if (!std::isfinite(minimos[k])) {
+            throw std::runtime_error("Minimo invalido en la restriccion " + std::to_string(k));
+        }
+    }
+}
+
+// Equivalente a compilar_curso, pero desde los arreglos planos. Las
+// máquinas identifican evaluaciones y restricciones por id, así que sus ids
+// son sus posiciones; la salida se escribe por índice, sin volver a leerlos.
+CursoCompilado construir_curso(const int32_t* enteros, const double* reales, const uint8_t* membresia) {
+    const int32_t n = enteros[ENTERO_EVALUACIONES];
+    const int32_t t = enteros[ENTERO_TAGS];
+    const int32_t r = enteros[ENTERO_RESTRICCIONES];
+    if (n < 0 || t < 0 || r < 0) throw std::runtime_error("Dimensiones invalidas");
+    if (n > 0 && t > 0 && membresia == nullptr) throw std::runtime_error("Falta la matriz de tags");
+
+    const double* pesos = reales + CABECERA_REALES;
+    const double* notas = pesos + n;
+    const double* minimos = notas + n;
+    const int32_t* tipos_tags = enteros + CABECERA_ENTEROS;
+
+    CursoCompilado curso;
+    curso.ctx = { reales[REAL_NOTA_MINIMA], reales[REAL_NOTA_MAXIMA], reales[REAL_NOTA_APROBACION] };
+    validar_entrada(curso.ctx, pesos, notas, n, minimos, r);
+
+    curso.ids.reserve(n);
+    curso.pesos.assign(pesos, pesos + n);
+    curso.notas_conocidas.assign(notas, notas + n);
+    curso.restricciones_por_evaluacion.resize(n);
+    for (int32_t i = 0; i < n; ++i) {
+        curso.ids.push_back(std::to_string(i));
+        curso.indice_evaluacion.emplace(curso.ids.back(), i);
+        if (std::isnan(notas[i])) curso.pendientes.push_back(i);
+    }
+
+    curso.tags.reserve(t);
+    for (int32_t k = 0; k < t; ++k) curso.tags.push_back(std::to_string(k));
+
+    curso.restricciones.reserve(r);
+    for (int32_t k = 0; k < r; ++k) {
+        const int32_t tipo = tipos_tags[2 * k];
+        const int32_t tag = tipos_tags[2 * k + 1];
+        if (tipo < 0 || tipo > static_cast<int32_t>(TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG)) {
+            throw std::runtime_error("Tipo de restriccion invalido en la restriccion " + std::to_string(k));
+        }
+        if (tag < 0 || tag >= t) {
+            throw std::runtime_error("Tag fuera de rango en la restriccion " + std::to_string(k));
+        }
+
+        RestriccionCompilada rc;
+        rc.tipo = static_cast<TipoRestriccion>(tipo);
+        rc.valor_minimo = minimos[k];
+        rc.tag = tag;
+        for (int32_t i = 0; i < n; ++i) {
+            if (membresia[static_cast<size_t>(i) * t + tag] != 0) {
+                rc.miembros.push_back(i);
+                curso.restricciones_por_evaluacion[i].push_back(k);
+            }
+        }
+
+        curso.ids_restricciones.push_back(std::to_string(k));
+        curso.restricciones.push_back(std::move(rc));
+    }
+
+    return curso;
+}
+
+} // namespace
+
+size_t resolver_binario(const int32_t* enteros, const double* reales, const uint8_t* membresia,
+                        double* salida, size_t largo_salida, const OpcionesSolver& opciones) {
+    if (enteros == nullptr || reales == nullptr) throw std::runtime_error("Entrada binaria nula");
+
+    const DisposicionSalida disposicion(std::max(enteros[ENTERO_EVALUACIONES], 0),
+                                        std::max(enteros[ENTERO_RESTRICCIONES], 0));
+    if (salida == nullptr || largo_salida < disposicion.largo) return disposicion.largo;
+
+    const auto curso = construir_curso(enteros, reales, membresia);
+
+    const int32_t muestreo = enteros[ENTERO_MUESTREO];
+    if (muestreo < 0 || muestreo > static_cast<int32_t>(Muestreo::IMPORTANCIA)) {
+        throw std::runtime_error("Muestreo invalido");
+    }
+
+    ParametrosSimulacion simulacion;
+    simulacion.simulaciones = enteros[ENTERO_SIMULACIONES] > 0 ? enteros[ENTERO_SIMULACIONES]
+                                                               : opciones.simulaciones_por_defecto;
+    simulacion.muestreo = static_cast<Muestreo>(muestreo);
+    if (enteros[ENTERO_BANDERAS] & BANDERA_SEMILLA) {
+        simulacion.semilla = static_cast<uint64_t>(static_cast<uint32_t>(enteros[ENTERO_SEMILLA_BAJA])) |
+                             static_cast<uint64_t>(static_cast<uint32_t>(enteros[ENTERO_SEMILLA_ALTA])) << 32;
+    }
+
+    std::optional<PerfilEstadistico> perfil;
+    if (enteros[ENTERO_BANDERAS] & BANDERA_PERFIL) {
+        perfil = PerfilEstadistico{ reales[REAL_MEDIA_HISTORICA], reales[REAL_DESVIACION_ESTANDAR] };
+        if (!std::isfinite(perfil->media_historica) || !(perfil->desviacion_estandar >= 0.0) ||
+            !std::isfinite(perfil->desviacion_estandar)) {
+            throw std::runtime_error("Perfil invalido: la media debe ser finita y la desviacion finita y >= 0");
+        }
+    }
+
+    const auto resultado = resolver_curso(curso, perfil, simulacion, opciones);
+
+    // ========== Escribir la salida ==========
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::fill(salida, salida + disposicion.largo, nan);
+
+    const auto& espacio = resultado.espacio_soluciones;
+    salida[0] = espacio.es_posible ? 1.0 : 0.0;
+
+    // Solo las pendientes tienen rango (y solo si el curso es posible)
+    for (int idx : curso.pendientes) {
+        const auto rango = espacio.rangos_por_evaluacion.find(curso.ids[idx]);
+        if (rango == espacio.rangos_por_evaluacion.end()) continue;
+        double* destino = salida + disposicion.rangos + 3 * static_cast<size_t>(idx);
+        destino[0] = rango->second.min_supervivencia;
+        destino[1] = rango->second.min_seguridad;
+        destino[2] = rango->second.max_posible;
+    }
+
+    // Las incumplibles son pocas; GLOBAL_PASS_LIMIT no es una restricción
+    const auto& incumplibles = espacio.restricciones_incumplibles;
+    for (size_t k = 0; k < curso.restricciones.size(); ++k) {
+        const bool incumplible =
+            std::find(incumplibles.begin(), incumplibles.end(), curso.ids_restricciones[k]) != incumplibles.end();
+        salida[disposicion.incumplibles + k] = incumplible ? 1.0 : 0.0;
+    }
+
+    const auto estrategias = estrategias_registradas();
+    for (size_t p = 0; p < estrategias.size(); ++p) {
+        const auto nombre = JSON::tipo_estrategia_to_string(estrategias[p]);
+        const auto plan = resultado.planes.find(nombre);
+        if (plan == resultado.planes.end()) continue;
+
+        double* bloque = salida + disposicion.planes + p * disposicion.por_plan;
+        bloque[PLAN_PROMEDIO_TEORICO] = plan->second.promedio_final_teorico;
+
+        const auto reporte = resultado.reportes_probabilidad.find(nombre);
+        if (reporte != resultado.reportes_probabilidad.end()) {
+            bloque[PLAN_PROBABILIDAD_GENERAL] = reporte->second.probabilidad_general;
+            bloque[PLAN_PROBABILIDAD_DEL_PLAN] = reporte->second.probabilidad_del_plan;
+            bloque[PLAN_VIABILIDAD] = reporte->second.viabilidad;
+        }
+
+        // Notas del escenario completo: conocidas y objetivo de las pendientes
+        double* notas = bloque + CABECERA_PLAN;
+        const auto& objetivo = plan->second.notas_objetivo;
+        for (size_t i = 0; i < curso.size(); ++i) notas[i] = curso.notas_conocidas[i];
+        for (int idx : curso.pendientes) {
+            const auto nota = objetivo.find(curso.ids[idx]);
+            if (nota != objetivo.end()) notas[idx] = nota->second;
+        }
+    }
+
+    return disposicion.largo;
+}
+
+} // namespace GradeSolver
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pipeline.hpp"
+
+namespace GradeSolver {
+
+// ============================================================================
+// ENTRADA/SALIDA BINARIA
+// ----------------------------------------------------------------------------
+// Alternativa a solve_process sin JSON: el curso llega en tres arreglos
+// planos y el resultado se escribe en un arreglo de doubles de quien llama.
+// Las evaluaciones, tags y restricciones se identifican por su posición.
+//
+// enteros (int32):  cabecera de CABECERA_ENTEROS valores (IndiceEntero) y
+//                   luego (tipo, tag) por restricción; tipo 0 =
+//                   PROMEDIO_SIMPLE_TAG, 1 = NOTA_MINIMA_INDIVIDUAL_TAG.
+// reales (double):  cabecera de CABECERA_REALES valores (IndiceReal), luego
+//                   pesos[n], notas[n] (NaN = pendiente) y minimos[r].
+// membresia (u8):   matriz n x t fila-mayor; distinto de 0 si la evaluación
+//                   tiene el tag.
+//
+// salida (double):  ver DisposicionSalida. Lo que no aplica (rangos de
+//                   evaluaciones conocidas, planes de un curso imposible)
+//                   queda en NaN.
+// ============================================================================
+
+enum IndiceEntero : int {
+    ENTERO_EVALUACIONES,
+    ENTERO_TAGS,
+    ENTERO_RESTRICCIONES,
+    ENTERO_SIMULACIONES,
+    ENTERO_MUESTREO,       // 0 = MC, 1 = QMC, 2 = IS
+    ENTERO_BANDERAS,       // BANDERA_SEMILLA | BANDERA_PERFIL
+    ENTERO_SEMILLA_BAJA,   // 32 bits bajos de la semilla
+    ENTERO_SEMILLA_ALTA,
+    CABECERA_ENTEROS
+};
+
+enum IndiceReal : int {
+    REAL_NOTA_MINIMA,
+    REAL_NOTA_MAXIMA,
+    REAL_NOTA_APROBACION,
+    REAL_MEDIA_HISTORICA,       // Solo con BANDERA_PERFIL
+    REAL_DESVIACION_ESTANDAR,
+    CABECERA_REALES
+};
+
+constexpr int32_t BANDERA_SEMILLA = 1;
+constexpr int32_t BANDERA_PERFIL = 2;
+
+// Valores por plan, antes de sus n notas objetivo
+enum IndicePlan : int {
+    PLAN_PROMEDIO_TEORICO,
+    PLAN_PROBABILIDAD_GENERAL,
+    PLAN_PROBABILIDAD_DEL_PLAN,
+    PLAN_VIABILIDAD,
+    CABECERA_PLAN
+};
+
+// Posiciones en la salida para n evaluaciones y r restricciones:
+//   [0]                  es_posible (0 o 1)
+//   [rangos + 3i ...]    min_supervivencia, min_seguridad, max_posible
+//   [incumplibles + k]   1 si la restricción k es incumplible
+//   [planes + p·por_plan] un bloque por estrategia, en el orden de
+//                        estrategias_registradas(): IndicePlan y notas[n]
+struct DisposicionSalida {
+    size_t rangos;
+    size_t incumplibles;
+    size_t planes;
+    size_t por_plan;
+    size_t largo;
+
+    DisposicionSalida(size_t evaluaciones, size_t restricciones)
+        : rangos(1),
+          incumplibles(rangos + 3 * evaluaciones),
+          planes(incumplibles + restricciones),
+          por_plan(CABECERA_PLAN + evaluaciones),
+          largo(planes + estrategias_registradas().size() * por_plan) {}
+};
+
+// Resuelve el curso y escribe el resultado en `salida`. Devuelve el largo
+// necesario (si es mayor que `largo_salida` no se escribe nada) o lanza
+// std::runtime_error si la entrada es inválida: escala no finita o con
+// nota_minima >= nota_maxima o la aprobación fuera de ella, pesos negativos
+// o no finitos, notas fuera de la escala (NaN = pendiente) o mínimos no
+// finitos.
+size_t resolver_binario(const int32_t* enteros, const double* reales, const uint8_t* membresia,
+                        double* salida, size_t largo_salida, const OpcionesSolver& opciones = {});
+
+} // namespace GradeSolver
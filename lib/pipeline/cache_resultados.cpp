@@ -0,0 +1,191 @@
+#include "cache_resultados.hpp"
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+namespace GradeSolver {
+
+namespace {
+
+// Costo fijo estimado por entrada (nodo del mapa, control del shared_ptr)
+constexpr size_t SOBRECARGA_ENTRADA = 96;
+
+class EscritorClave {
+public:
+    void entero(uint64_t valor) {
+        for (int b = 0; b < 8; ++b) datos_.push_back(static_cast<char>((valor >> (8 * b)) & 0xFF));
+    }
+
+    void real(double valor) {
+        if (valor == 0.0) valor = 0.0;  // -0.0 -> 0.0
+        if (std::isnan(valor)) valor = std::numeric_limits<double>::quiet_NaN();
+        entero(std::bit_cast<uint64_t>(valor));
+    }
+
+    void texto(const std::string& valor) {
+        entero(valor.size());
+        datos_ += valor;
+    }
+
+    template <typename T, typename F>
+    void opcional(const std::optional<T>& valor, F&& escribir) {
+        entero(valor.has_value() ? 1 : 0);
+        if (valor.has_value()) escribir(*valor);
+    }
+
+    std::string terminar() { return std::move(datos_); }
+
+private:
+    std::string datos_;
+};
+
+} // namespace
+
+uint64_t hash_fnv1a(std::string_view datos) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char c : datos) {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+std::optional<std::string> clave_canonica(const JSON::EntradaCompleta& entrada,
+                                          const OpcionesSolver& opciones) {
+    if (!entrada.semilla.has_value()) return std::nullopt;
+
+    // Los parámetros efectivos, con los valores por defecto ya resueltos
+    const auto simulacion = parametros_simulacion(entrada, opciones);
+
+    EscritorClave clave;
+    clave.texto("GS1");
+    clave.entero(static_cast<uint64_t>(opciones.metodo_limites));
+
+    clave.real(entrada.contexto.nota_minima);
+    clave.real(entrada.contexto.nota_maxima);
+    clave.real(entrada.contexto.nota_aprobacion);
+
+    clave.entero(entrada.evaluaciones.size());
+    for (const auto& eval : entrada.evaluaciones) {
+        clave.texto(eval.id);
+        clave.real(eval.peso);
+        clave.opcional(eval.valor_actual, [&](double v) { clave.real(v); });
+        clave.entero(eval.tags.size());
+        for (const auto& tag : eval.tags) clave.texto(tag);
+    }
+
+    clave.entero(entrada.restricciones.size());
+    for (const auto& res : entrada.restricciones) {
+        clave.texto(res.id);
+        clave.entero(static_cast<uint64_t>(res.tipo));
+        clave.texto(res.tag_objetivo);
+        clave.real(res.valor_minimo);
+    }
+
+    clave.entero(static_cast<uint64_t>(simulacion.simulaciones));
+    clave.entero(*simulacion.semilla);
+    clave.opcional(simulacion.precision, [&](const PrecisionObjetivo& p) {
+        clave.real(p.semiancho);
+        clave.real(p.confianza);
+    });
+    clave.entero(static_cast<uint64_t>(simulacion.muestreo));
+    clave.entero(static_cast<uint64_t>(simulacion.puntos_frontera));
+    clave.opcional(entrada.perfil, [&](const PerfilEstadistico& perfil) {
+        clave.real(perfil.media_historica);
+        clave.real(perfil.desviacion_estandar);
+    });
+
+    return clave.terminar();
+}
+
+CacheResultados::CacheResultados(size_t capacidad_bytes) : capacidad_bytes_(capacidad_bytes) {}
+
+std::shared_ptr<const std::string> CacheResultados::buscar(const std::string& clave) {
+    std::shared_lock candado(mutex_);
+    auto it = entradas_.find(clave);
+    if (it == entradas_.end()) {
+        fallos_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    it->second.ultimo_uso.store(reloj_.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    aciertos_.fetch_add(1, std::memory_order_relaxed);
+    return it->second.valor;
+}
+
+void CacheResultados::guardar(const std::string& clave, std::shared_ptr<const std::string> valor) {
+    if (valor == nullptr) return;
+    const size_t bytes = clave.size() + valor->size() + SOBRECARGA_ENTRADA;
+
+    std::unique_lock candado(mutex_);
+    if (bytes > capacidad_bytes_) return;  // No cabe ni con la cache vacía
+
+    auto [it, nueva] = entradas_.try_emplace(clave);
+    if (!nueva) bytes_ -= it->second.bytes;
+    it->second.valor = std::move(valor);
+    it->second.bytes = bytes;
+    it->second.ultimo_uso.store(reloj_.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    bytes_ += bytes;
+
+    expulsar_hasta(capacidad_bytes_);
+}
+
+void CacheResultados::expulsar_hasta(size_t capacidad_bytes) {
+    // Expulsar la de uso más antiguo. El recorrido es lineal, pero solo
+    // ocurre al guardar un resultado nuevo, que cuesta una resolución
+    // completa.
+    while (bytes_ > capacidad_bytes && !entradas_.empty()) {
+        auto victima = entradas_.begin();
+        for (auto it = entradas_.begin(); it != entradas_.end(); ++it) {
+            if (it->second.ultimo_uso.load(std::memory_order_relaxed) <
+                victima->second.ultimo_uso.load(std::memory_order_relaxed)) {
+                victima = it;
+            }
+        }
+        bytes_ -= victima->second.bytes;
+        entradas_.erase(victima);
+        expulsadas_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void CacheResultados::configurar_capacidad(size_t capacidad_bytes) {
+    std::unique_lock candado(mutex_);
+    capacidad_bytes_ = capacidad_bytes;
+    expulsar_hasta(capacidad_bytes_);
+}
+
+void CacheResultados::limpiar() {
+    std::unique_lock candado(mutex_);
+    entradas_.clear();
+    bytes_ = 0;
+}
+
+EstadisticasCache CacheResultados::estadisticas() const {
+    std::shared_lock candado(mutex_);
+    EstadisticasCache e;
+    e.aciertos = aciertos_.load(std::memory_order_relaxed);
+    e.fallos = fallos_.load(std::memory_order_relaxed);
+    e.omitidas = omitidas_.load(std::memory_order_relaxed);
+    e.expulsadas = expulsadas_.load(std::memory_order_relaxed);
+    e.entradas = entradas_.size();
+    e.bytes = bytes_;
+    e.capacidad_bytes = capacidad_bytes_;
+    return e;
+}
+
+std::shared_ptr<const std::string> resolver_memorizado(const JSON::EntradaCompleta& entrada,
+                                                       const OpcionesSolver& opciones,
+                                                       CacheResultados& cache) {
+    auto clave = clave_canonica(entrada, opciones);
+    if (!clave.has_value()) {
+        cache.registrar_omitida();
+    } else if (auto guardado = cache.buscar(*clave)) {
+        return guardado;
+    }
+
+    auto salida = std::make_shared<const std::string>(JSON::to_json(resolver(entrada, opciones)).dump());
+    if (clave.has_value()) cache.guardar(*clave, salida);
+    return salida;
+}
+
+} // namespace GradeSolver
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "pipeline.hpp"
+
+namespace GradeSolver {
+
+// ============================================================================
+// CACHE DE RESULTADOS
+// ----------------------------------------------------------------------------
+// Memoriza la salida serializada de `resolver` por una clave canónica de la
+// entrada. Solo se usa cuando la entrada trae semilla: sin ella la Máquina P
+// no es reproducible y guardar su salida cambiaría el resultado.
+// ============================================================================
+
+constexpr size_t CAPACIDAD_CACHE_POR_DEFECTO = 16u << 20;  // 16 MB
+
+// Clave canónica de una entrada ya parseada: orden de campos fijo, números
+// por su representación binaria (-0.0 = 0.0) y los valores por defecto
+// explícitos, así que espacios, orden de claves JSON o "7" frente a "7.0"
+// no cambian la clave. El orden de evaluaciones y restricciones sí se
+// conserva: fija los flujos aleatorios, los desempates de la Máquina D y el
+// orden de la salida. nullopt si la entrada no trae semilla.
+std::optional<std::string> clave_canonica(const JSON::EntradaCompleta& entrada,
+                                          const OpcionesSolver& opciones = {});
+
+uint64_t hash_fnv1a(std::string_view datos);
+
+struct EstadisticasCache {
+    uint64_t aciertos = 0;
+    uint64_t fallos = 0;
+    uint64_t omitidas = 0;      // Entradas sin semilla: no pasan por la cache
+    uint64_t expulsadas = 0;
+    size_t entradas = 0;
+    size_t bytes = 0;
+    size_t capacidad_bytes = 0;
+};
+
+// LRU acotada por memoria. Las búsquedas toman el candado compartido y solo
+// marcan el uso con un contador atómico; guardar y expulsar toman el
+// exclusivo. Dos fallos simultáneos de la misma clave calculan ambos y el
+// segundo en guardar reemplaza al primero (los valores son idénticos).
+class CacheResultados {
+public:
+    explicit CacheResultados(size_t capacidad_bytes = CAPACIDAD_CACHE_POR_DEFECTO);
+
+    std::shared_ptr<const std::string> buscar(const std::string& clave);
+    void guardar(const std::string& clave, std::shared_ptr<const std::string> valor);
+    void registrar_omitida() { omitidas_.fetch_add(1, std::memory_order_relaxed); }
+
+    // 0 desactiva la cache; al achicarla se expulsan las menos usadas
+    void configurar_capacidad(size_t capacidad_bytes);
+    void limpiar();
+    EstadisticasCache estadisticas() const;
+
+private:
+    struct HashClave {
+        size_t operator()(const std::string& clave) const { return static_cast<size_t>(hash_fnv1a(clave)); }
+    };
+
+    struct Entrada {
+        std::shared_ptr<const std::string> valor;
+        size_t bytes = 0;
+        std::atomic<uint64_t> ultimo_uso { 0 };
+    };
+
+    void expulsar_hasta(size_t capacidad_bytes);  // Requiere el candado exclusivo
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, Entrada, HashClave> entradas_;
+    size_t bytes_ = 0;
+    size_t capacidad_bytes_;
+
+    std::atomic<uint64_t> reloj_ { 0 };
+    std::atomic<uint64_t> aciertos_ { 0 };
+    std::atomic<uint64_t> fallos_ { 0 };
+    std::atomic<uint64_t> omitidas_ { 0 };
+    std::atomic<uint64_t> expulsadas_ { 0 };
+};
+
+// `resolver` + to_json + dump, pasando por `cache` cuando la entrada trae
+// semilla
+std::shared_ptr<const std::string> resolver_memorizado(const JSON::EntradaCompleta& entrada,
+                                                       const OpcionesSolver& opciones,
+                                                       CacheResultados& cache);
+
+} // namespace GradeSolver
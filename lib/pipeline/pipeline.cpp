@@ -0,0 +1,272 @@
+#include "pipeline.hpp"
+#include "paralelo.hpp"
+#include "aleatorio.hpp"
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+
+namespace GradeSolver {
+
+namespace {
+
+// Máquinas de un hilo de trabajo, creadas una vez y reutilizadas
+struct Maquinas {
+    MaquinaS s;
+    MaquinaD d;
+    MaquinaP p;
+
+    Maquinas(const Contexto& ctx, const OpcionesSolver& opciones, std::optional<uint64_t> semilla, int hilos)
+        : s(ctx, opciones.metodo_limites, hilos), d(ctx), p(ctx, semilla, hilos) {}
+};
+
+// Lo que resuelven S y D, y los planes que puntúa la Máquina P
+struct PreparacionP {
+    JSON::ResultadoEstudiante resultado;
+    PerfilEstadistico perfil;
+    std::vector<Sugerencias> planes;   // Los de las estrategias y luego los de la frontera
+    std::vector<PlanFrontera> frontera;
+};
+
+PreparacionP preparar(Maquinas& maquinas, const CursoCompilado& curso,
+                      const std::optional<PerfilEstadistico>& perfil_entrada,
+                      const ParametrosSimulacion& simulacion) {
+    PreparacionP preparacion;
+    auto& resultado = preparacion.resultado;
+
+    // ========== MAQUINA S: Calcular Espacio de Soluciones ==========
+    resultado.espacio_soluciones = maquinas.s.calcular_espacio(curso);
+    if (!resultado.espacio_soluciones.es_posible) return preparacion;
+
+    // ========== MAQUINA D: Generar Planes ==========
+    for (auto& plan : maquinas.d.generar_planes(resultado.espacio_soluciones, curso)) {
+        resultado.planes[JSON::tipo_estrategia_to_string(plan.estrategia_aplicada.value())] = std::move(plan);
+    }
+
+    // ========== MAQUINA P: Calcular Perfil y Probabilidades ==========
+    preparacion.perfil = perfil_entrada.has_value() ? perfil_entrada.value() : estimar_perfil(curso);
+
+    // Una sola pasada de simulación para todos los planes, los de la
+    // frontera incluidos
+    preparacion.frontera = maquinas.d.generar_frontera(resultado.espacio_soluciones, curso,
+                                                       simulacion.puntos_frontera);
+
+    auto& planes = preparacion.planes;
+    planes.reserve(resultado.planes.size() + preparacion.frontera.size());
+    for (const auto& [nombre, plan] : resultado.planes) planes.push_back(plan);
+    for (const auto& punto : preparacion.frontera) planes.push_back(punto.plan);
+    return preparacion;
+}
+
+// Reparte los reportes de la Máquina P (en el orden de `planes`)
+JSON::ResultadoEstudiante completar(PreparacionP preparacion, std::vector<ReporteProbabilidad> reportes) {
+    auto& resultado = preparacion.resultado;
+    auto& frontera = preparacion.frontera;
+
+    size_t p = 0;
+    for (const auto& [nombre, plan] : resultado.planes) {
+        resultado.reportes_probabilidad[nombre] = reportes[p++];
+    }
+
+    resultado.frontera.reserve(frontera.size());
+    for (auto& punto : frontera) {
+        resultado.frontera.push_back({ punto.nivel, std::move(punto.plan), std::move(reportes[p++]) });
+    }
+
+    resultado.perfil_usado = preparacion.perfil;
+    return std::move(resultado);
+}
+
+JSON::ResultadoEstudiante resolver_con(Maquinas& maquinas, const CursoCompilado& curso,
+                                       const std::optional<PerfilEstadistico>& perfil_entrada,
+                                       const ParametrosSimulacion& simulacion) {
+    auto preparacion = preparar(maquinas, curso, perfil_entrada, simulacion);
+    if (!preparacion.resultado.espacio_soluciones.es_posible) return std::move(preparacion.resultado);
+
+    auto reportes = maquinas.p.analizar_planes(preparacion.resultado.espacio_soluciones, preparacion.planes, curso,
+                                               preparacion.perfil, simulacion.simulaciones, simulacion.precision,
+                                               simulacion.muestreo);
+    return completar(std::move(preparacion), std::move(reportes));
+}
+
+JSON::SalidaCompleta armar_salida(const JSON::EntradaCompleta& entrada, JSON::ResultadoEstudiante resultado) {
+    JSON::SalidaCompleta salida;
+    salida.contexto = entrada.contexto;
+    salida.evaluaciones = entrada.evaluaciones;
+    salida.restricciones = entrada.restricciones;
+    salida.espacio_soluciones = std::move(resultado.espacio_soluciones);
+    salida.planes = std::move(resultado.planes);
+    salida.reportes_probabilidad = std::move(resultado.reportes_probabilidad);
+    salida.frontera = std::move(resultado.frontera);
+    salida.perfil_usado = resultado.perfil_usado;
+    return salida;
+}
+
+} // namespace
+
+PerfilEstadistico estimar_perfil(const CursoCompilado& curso) {
+    const auto& contexto = curso.ctx;
+    PerfilEstadistico perfil;
+
+    // Calcular perfil basado en notas existentes o valores por defecto
+    std::vector<double> notas_existentes;
+    for (size_t i = 0; i < curso.size(); ++i) {
+        if (curso.es_conocida(static_cast<int>(i))) {
+            notas_existentes.push_back(curso.notas_conocidas[i]);
+        }
+    }
+
+    if (!notas_existentes.empty()) {
+        double suma = 0.0;
+        for (double n : notas_existentes) suma += n;
+        perfil.media_historica = suma / notas_existentes.size();
+
+        double suma_cuadrados = 0.0;
+        for (double n : notas_existentes) {
+            double diff = n - perfil.media_historica;
+            suma_cuadrados += diff * diff;
+        }
+        perfil.desviacion_estandar = std::sqrt(suma_cuadrados / notas_existentes.size());
+
+        // Desviación mínima: 10% del rango de notas (escalable a cualquier sistema)
+        double desv_minima = (contexto.nota_maxima - contexto.nota_minima) * 0.10;
+        if (perfil.desviacion_estandar < desv_minima) {
+            perfil.desviacion_estandar = desv_minima;
+        }
+    } else {
+        perfil.media_historica = contexto.nota_aprobacion + (contexto.nota_maxima - contexto.nota_aprobacion) * 0.2;
+        perfil.desviacion_estandar = (contexto.nota_maxima - contexto.nota_minima) / 4.0;
+    }
+
+    return perfil;
+}
+
+ParametrosSimulacion parametros_simulacion(const JSON::EntradaCompleta& entrada,
+                                           const OpcionesSolver& opciones) {
+    ParametrosSimulacion simulacion;
+    simulacion.semilla = entrada.semilla;
+    simulacion.precision = entrada.precision;
+    simulacion.muestreo = entrada.muestreo.value_or(Muestreo::MONTE_CARLO);
+
+    // En el modo de precisión "simulaciones" es el tope
+    const int por_defecto = entrada.precision.has_value() ? opciones.simulaciones_maximas
+                                                          : opciones.simulaciones_por_defecto;
+    simulacion.simulaciones = entrada.simulaciones.value_or(por_defecto);
+    simulacion.puntos_frontera = entrada.puntos_frontera.value_or(0);
+    return simulacion;
+}
+
+JSON::ResultadoEstudiante resolver_curso(const CursoCompilado& curso,
+                                         const std::optional<PerfilEstadistico>& perfil,
+                                         const ParametrosSimulacion& simulacion,
+                                         const OpcionesSolver& opciones) {
+    Maquinas maquinas(curso.ctx, opciones, simulacion.semilla, opciones.hilos);
+    return resolver_con(maquinas, curso, perfil, simulacion);
+}
+
+JSON::SalidaCompleta resolver(const JSON::EntradaCompleta& entrada, const OpcionesSolver& opciones) {
+    // Compilar el curso una sola vez: todas las máquinas trabajan sobre índices
+    auto curso = compilar_curso(entrada.contexto, entrada.evaluaciones, entrada.restricciones);
+    auto resultado = resolver_curso(curso, entrada.perfil, parametros_simulacion(entrada, opciones), opciones);
+    return armar_salida(entrada, std::move(resultado));
+}
+
+// El análisis guarda referencias al curso, al espacio, a los planes y a la
+// Máquina P: todo vive en el estado, que no se mueve
+struct ResolucionPorTramos::Estado {
+    JSON::EntradaCompleta entrada;
+    CursoCompilado curso;
+    ParametrosSimulacion simulacion;
+    Maquinas maquinas;
+    PreparacionP preparacion;
+    std::optional<AnalisisPorTramos> analisis;
+
+    Estado(JSON::EntradaCompleta entrada_, const OpcionesSolver& opciones)
+        : entrada(std::move(entrada_)),
+          curso(compilar_curso(entrada.contexto, entrada.evaluaciones, entrada.restricciones)),
+          simulacion(parametros_simulacion(entrada, opciones)),
+          maquinas(curso.ctx, opciones, simulacion.semilla, opciones.hilos) {}
+};
+
+ResolucionPorTramos::ResolucionPorTramos(JSON::EntradaCompleta entrada, int simulaciones_por_tramo,
+                                         const OpcionesSolver& opciones)
+    : estado(std::make_unique<Estado>(std::move(entrada), opciones)) {
+    auto& e = *estado;
+    e.preparacion = preparar(e.maquinas, e.curso, e.entrada.perfil, e.simulacion);
+    if (!e.preparacion.resultado.espacio_soluciones.es_posible) return;
+
+    e.analisis.emplace(e.maquinas.p.analizar_por_tramos(
+        e.preparacion.resultado.espacio_soluciones, e.preparacion.planes, e.curso, e.preparacion.perfil,
+        e.simulacion.simulaciones, e.simulacion.precision, e.simulacion.muestreo, simulaciones_por_tramo));
+}
+
+ResolucionPorTramos::~ResolucionPorTramos() = default;
+
+bool ResolucionPorTramos::avanzar() {
+    return estado->analisis.has_value() && estado->analisis->avanzar();
+}
+
+bool ResolucionPorTramos::terminado() const {
+    return !estado->analisis.has_value() || estado->analisis->terminado();
+}
+
+std::map<std::string, ReporteProbabilidad> ResolucionPorTramos::reportes_parciales() const {
+    std::map<std::string, ReporteProbabilidad> parciales;
+    if (!estado->analisis.has_value()) return parciales;
+
+    const auto& reportes = estado->analisis->reportes();
+    if (reportes.empty()) return parciales;
+
+    size_t p = 0;
+    for (const auto& [nombre, plan] : estado->preparacion.resultado.planes) parciales[nombre] = reportes[p++];
+    return parciales;
+}
+
+int ResolucionPorTramos::simulaciones_usadas() const {
+    if (!estado->analisis.has_value() || estado->analisis->reportes().empty()) return 0;
+    return estado->analisis->reportes().front().simulaciones_usadas;
+}
+
+int ResolucionPorTramos::simulaciones_totales() const {
+    return std::max(estado->simulacion.simulaciones, 0);
+}
+
+JSON::SalidaCompleta ResolucionPorTramos::resultado() const {
+    if (!terminado()) throw std::logic_error("La resolucion por tramos no ha terminado");
+
+    if (!estado->analisis.has_value()) return armar_salida(estado->entrada, estado->preparacion.resultado);
+    return armar_salida(estado->entrada, completar(estado->preparacion, estado->analisis->reportes()));
+}
+
+uint64_t semilla_estudiante(uint64_t semilla, size_t estudiante) {
+    // Misma derivación que el flujo de cada escenario de la Máquina P
+    return GeneradorContador(semilla).flujo(static_cast<uint64_t>(estudiante));
+}
+
+std::vector<JSON::ResultadoEstudiante> resolver_cohorte(const JSON::EntradaCohorte& entrada,
+                                                        const OpcionesSolver& opciones) {
+    const auto& base = entrada.curso;
+    const auto plantilla = compilar_curso(base.contexto, base.evaluaciones, base.restricciones);
+    const size_t n = plantilla.size();
+    const auto simulacion = parametros_simulacion(base, opciones);
+
+    std::vector<JSON::ResultadoEstudiante> resultados(entrada.estudiantes);
+
+    // El paralelismo va por estudiante; dentro de cada uno todo es serial
+    ejecutar_en_paralelo(entrada.estudiantes, opciones.hilos, 1, [&](size_t inicio, size_t fin) {
+        CursoCompilado curso = plantilla;
+        Maquinas maquinas(plantilla.ctx, opciones, simulacion.semilla, 1);
+
+        for (size_t e = inicio; e < fin; ++e) {
+            curso.asignar_notas(std::span<const double>(entrada.notas.data() + e * n, n));
+            if (simulacion.semilla) {
+                maquinas.p = MaquinaP(plantilla.ctx, semilla_estudiante(*simulacion.semilla, e), 1);
+            }
+            resultados[e] = resolver_con(maquinas, curso, base.perfil, simulacion);
+        }
+    });
+
+    return resultados;
+}
+
+} // namespace GradeSolver
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "index.hpp"
+#include "curso_compilado.hpp"
+#include "interface_s.hpp"
+#include "interface_d.hpp"
+#include "interface_p.hpp"
+#include "json_serializer.hpp"
+
+namespace GradeSolver {
+
+// ============================================================================
+// PIPELINE S -> D -> P
+// ============================================================================
+
+struct OpcionesSolver {
+    int hilos = 1;                                  // 0 = todos los núcleos
+    MetodoLimites metodo_limites = MetodoLimites::EXACTO;
+    int simulaciones_por_defecto = 10000;           // Si la entrada no trae "simulaciones"
+    int simulaciones_maximas = 1000000;             // Tope del modo de precisión sin "simulaciones"
+};
+
+// Parámetros de la Máquina P tomados de la sección "P" de la entrada
+struct ParametrosSimulacion {
+    int simulaciones;                               // Fijas, o tope con `precision`
+    std::optional<uint64_t> semilla;
+    std::optional<PrecisionObjetivo> precision;
+    Muestreo muestreo = Muestreo::MONTE_CARLO;
+
+    // Planes de la frontera de la Máquina D (sección "D") que se puntúan en
+    // la misma pasada que los de las estrategias; 0 = sin frontera
+    int puntos_frontera = 0;
+};
+
+ParametrosSimulacion parametros_simulacion(const JSON::EntradaCompleta& entrada,
+                                           const OpcionesSolver& opciones = {});
+
+// Perfil estimado a partir de las notas conocidas cuando la entrada no trae uno
+PerfilEstadistico estimar_perfil(const CursoCompilado& curso);
+
+// Ejecuta las tres máquinas sobre un curso ya compilado. Con `semilla` la
+// Máquina P es reproducible y da lo mismo con cualquier número de hilos.
+JSON::ResultadoEstudiante resolver_curso(const CursoCompilado& curso,
+                                         const std::optional<PerfilEstadistico>& perfil,
+                                         const ParametrosSimulacion& simulacion,
+                                         const OpcionesSolver& opciones = {});
+
+// Entrada completa -> salida completa (lo que devuelve solve_process)
+JSON::SalidaCompleta resolver(const JSON::EntradaCompleta& entrada,
+                              const OpcionesSolver& opciones = {});
+
+// Resolución de una entrada con la Máquina P de a tramos, para mostrar
+// estimaciones tempranas y poder abandonar el trabajo a medio camino. S y D se
+// resuelven al construir; cada avanzar() simula un tramo. Con semilla el
+// resultado final es el mismo que el de resolver().
+class ResolucionPorTramos {
+public:
+    ResolucionPorTramos(JSON::EntradaCompleta entrada, int simulaciones_por_tramo,
+                        const OpcionesSolver& opciones = {});
+    ~ResolucionPorTramos();
+
+    // Simula el siguiente tramo; false cuando ya no quedan
+    bool avanzar();
+
+    bool terminado() const;
+
+    // Reportes de las estrategias con lo simulado hasta ahora (vacío antes
+    // del primer tramo o si el espacio no es posible)
+    std::map<std::string, ReporteProbabilidad> reportes_parciales() const;
+
+    int simulaciones_usadas() const;
+
+    // Tope de simulaciones (el modo de precisión puede terminar antes)
+    int simulaciones_totales() const;
+
+    // Salida completa; solo cuando terminado()
+    JSON::SalidaCompleta resultado() const;
+
+private:
+    struct Estado;
+    std::unique_ptr<Estado> estado;
+};
+
+// Semilla de la Máquina P del estudiante `estudiante` de una cohorte con
+// semilla `semilla`: cada uno tiene su propio flujo aleatorio, así que dos
+// estudiantes con las mismas notas no comparten escenarios
+uint64_t semilla_estudiante(uint64_t semilla, size_t estudiante);
+
+// Resuelve el mismo curso para todos los estudiantes de una cohorte. El curso
+// se compila una vez; cada hilo reutiliza su copia y sus máquinas y solo
+// reemplaza las notas conocidas de cada estudiante. Con semilla, la fila e
+// es lo que da `resolver` con sus notas y semilla_estudiante(semilla, e),
+// con cualquier número de hilos.
+std::vector<JSON::ResultadoEstudiante> resolver_cohorte(const JSON::EntradaCohorte& entrada,
+                                                        const OpcionesSolver& opciones = {});
+
+} // namespace GradeSolver
@@ -0,0 +1,127 @@
+#include "sesion.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+SesionSolver::SesionSolver(const Contexto& contexto,
+                           const std::vector<Evaluacion>& evaluaciones,
+                           const std::vector<Restriccion>& restricciones)
+    : SesionSolver(compilar_curso(contexto, evaluaciones, restricciones)) {}
+
+SesionSolver::SesionSolver(CursoCompilado curso)
+    : curso_(std::move(curso)),
+      agregados(AgregadosCurso::desde(curso_)),
+      maquina_s(curso_.ctx),
+      maquina_d(curso_.ctx),
+      planes(estrategias_registradas().size()) {
+    fallas_max = agregados.contar_fallas(curso_, curso_.ctx.nota_maxima);
+    fallas_aprobacion = agregados.contar_fallas(curso_, curso_.ctx.nota_aprobacion);
+}
+
+int SesionSolver::indice_o_error(const std::string& id) const {
+    int idx = curso_.indice(id);
+    if (idx < 0) throw std::runtime_error("Evaluacion desconocida: " + id);
+    return idx;
+}
+
+void SesionSolver::contar_fallas(int idx, int signo) {
+    // Solo las restricciones que contienen a idx pueden cambiar de estado
+    for (int r : curso_.restricciones_por_evaluacion[idx]) {
+        if (agregados.restriccion_falla(curso_, r, curso_.ctx.nota_maxima)) fallas_max += signo;
+        if (agregados.restriccion_falla(curso_, r, curso_.ctx.nota_aprobacion)) fallas_aprobacion += signo;
+    }
+}
+
+void SesionSolver::invalidar() {
+    espacio_vigente = false;
+    planes_vigentes = false;
+}
+
+void SesionSolver::set_grade(const std::string& id, double valor) {
+    int idx = indice_o_error(id);
+    const auto& ctx = curso_.ctx;
+    // Una nota NaN dejaría la evaluación como pendiente sin pasar por
+    // clear_grade y desajustaría los agregados
+    if (!std::isfinite(valor) || valor < ctx.nota_minima || valor > ctx.nota_maxima) {
+        throw std::runtime_error("Nota fuera de rango para " + id + ": debe estar entre " +
+                                 std::to_string(ctx.nota_minima) + " y " + std::to_string(ctx.nota_maxima));
+    }
+
+    contar_fallas(idx, -1);
+    if (curso_.es_conocida(idx)) {
+        agregados.retirar_nota(curso_, idx, curso_.notas_conocidas[idx]);
+    }
+    agregados.registrar_nota(curso_, idx, valor);
+    curso_.notas_conocidas[idx] = valor;
+    contar_fallas(idx, +1);
+
+    invalidar();
+}
+
+void SesionSolver::clear_grade(const std::string& id) {
+    int idx = indice_o_error(id);
+    if (!curso_.es_conocida(idx)) return;
+
+    contar_fallas(idx, -1);
+    agregados.retirar_nota(curso_, idx, curso_.notas_conocidas[idx]);
+    curso_.notas_conocidas[idx] = std::numeric_limits<double>::quiet_NaN();
+    contar_fallas(idx, +1);
+
+    invalidar();
+}
+
+bool SesionSolver::es_posible() const {
+    const auto& ctx = curso_.ctx;
+    double optimista = agregados.suma_ponderada_conocida + ctx.nota_maxima * agregados.peso_pendiente;
+    return fallas_max == 0 && optimista >= ctx.nota_aprobacion;
+}
+
+RangoFactible SesionSolver::rango(const std::string& id) const {
+    int idx = indice_o_error(id);
+    if (curso_.es_conocida(idx)) throw std::runtime_error("La evaluacion ya tiene nota: " + id);
+
+    const auto& ctx = curso_.ctx;
+    auto resolver = [&](double relleno, int fallas) {
+        double limite = agregados.limite_inferior(curso_, idx, relleno, fallas);
+        if (!(limite <= ctx.nota_maxima)) return ctx.nota_maxima;
+        return std::max(limite, ctx.nota_minima);
+    };
+
+    return { resolver(ctx.nota_maxima, fallas_max),
+             resolver(ctx.nota_aprobacion, fallas_aprobacion),
+             ctx.nota_maxima };
+}
+
+const EspacioSoluciones& SesionSolver::espacio() {
+    if (espacio_vigente) return espacio_;
+
+    // Reconstruir la lista de pendientes en orden de entrada
+    curso_.pendientes.clear();
+    for (size_t i = 0; i < curso_.size(); ++i) {
+        if (!curso_.es_conocida(static_cast<int>(i))) curso_.pendientes.push_back(static_cast<int>(i));
+    }
+
+    // Recalcular los agregados desde cero descarta el error de redondeo
+    // acumulado por las sumas y restas incrementales
+    agregados = AgregadosCurso::desde(curso_);
+    fallas_max = agregados.contar_fallas(curso_, curso_.ctx.nota_maxima);
+    fallas_aprobacion = agregados.contar_fallas(curso_, curso_.ctx.nota_aprobacion);
+
+    espacio_ = maquina_s.calcular_espacio(curso_);
+    espacio_vigente = true;
+    return espacio_;
+}
+
+const Sugerencias& SesionSolver::sugerencias(TipoEstrategia estrategia) {
+    const auto& esp = espacio();
+    // Los planes se piden juntos (binding, CLI), así que se generan todos en
+    // una pasada
+    if (!planes_vigentes) {
+        for (auto& plan : maquina_d.generar_planes(esp, curso_)) {
+            planes[static_cast<size_t>(plan.estrategia_aplicada.value())] = std::move(plan);
+        }
+        planes_vigentes = true;
+    }
+    return planes[static_cast<size_t>(estrategia)];
+}
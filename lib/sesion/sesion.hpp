@@ -0,0 +1,59 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "index.hpp"
+#include "curso_compilado.hpp"
+#include "interface_s.hpp"
+#include "interface_d.hpp"
+
+// ============================================================================
+// SESIÓN INCREMENTAL
+// ----------------------------------------------------------------------------
+// Mantiene un curso compilado y sus agregados (sumas ponderadas globales y
+// por restricción). Cambiar una nota solo toca las restricciones cuyo tag
+// incluye esa evaluación; el espacio completo y los planes se recalculan
+// de forma perezosa la próxima vez que se consultan.
+// ============================================================================
+
+class SesionSolver {
+public:
+    SesionSolver(const Contexto& contexto,
+                 const std::vector<Evaluacion>& evaluaciones,
+                 const std::vector<Restriccion>& restricciones);
+
+    explicit SesionSolver(CursoCompilado curso);
+
+    // Ruta de cada pulsación: O(tags de la evaluación). Lanza si el id no
+    // existe o si la nota no es finita o cae fuera de [nota_minima, nota_maxima]
+    void set_grade(const std::string& id, double valor);
+    void clear_grade(const std::string& id);
+
+    // Consultas baratas sobre los agregados
+    bool es_posible() const;
+    RangoFactible rango(const std::string& id) const;  // Solo evaluaciones pendientes
+
+    // Resultados completos (se recalculan solo si hubo cambios)
+    const EspacioSoluciones& espacio();
+    const Sugerencias& sugerencias(TipoEstrategia estrategia);
+
+    // Notas vigentes; la lista de pendientes se refresca al llamar a espacio()
+    const CursoCompilado& curso() const { return curso_; }
+
+private:
+    CursoCompilado curso_;
+    AgregadosCurso agregados;
+    int fallas_max = 0;
+    int fallas_aprobacion = 0;
+
+    MaquinaS maquina_s;
+    MaquinaD maquina_d;
+
+    EspacioSoluciones espacio_;
+    std::vector<Sugerencias> planes;  // Indexado por TipoEstrategia
+    bool espacio_vigente = false;
+    bool planes_vigentes = false;
+
+    int indice_o_error(const std::string& id) const;
+    void contar_fallas(int idx, int signo);
+    void invalidar();
+};
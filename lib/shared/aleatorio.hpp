@@ -0,0 +1,122 @@
+#pragma once
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+// ============================================================================
+// NÚMEROS ALEATORIOS BASADOS EN CONTADOR
+// ----------------------------------------------------------------------------
+// Cada valor es una función pura de (semilla, flujo, contador): no hay estado
+// que avanzar, así que cualquier hilo puede generar cualquier escenario y el
+// resultado no depende de cómo se repartió el trabajo. La mezcla es la
+// función final de SplitMix64.
+// ============================================================================
+
+inline uint64_t mezclar_64(uint64_t z) {
+    z += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Semilla fresca cuando el usuario no entrega una
+inline uint64_t semilla_aleatoria() {
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+}
+
+// ============================================================================
+// Funciones elementales sin saltos
+// ----------------------------------------------------------------------------
+// Polinomios y manipulación de bits en lugar de std::log/std::cos para que
+// los ciclos sobre bloques de escenarios se vectoricen, y para que el valor
+// sea el mismo bit a bit en la versión escalar y en la vectorial (compilando
+// sin contracción a FMA).
+// ============================================================================
+
+// Entero menor que 2^52 a double, sin instrucciones de conversión
+inline double entero_a_double(uint64_t x) {
+    return std::bit_cast<double>(x | 0x4330000000000000ULL) - 4503599627370496.0;
+}
+
+// log(u) para u normal positivo (error < 2 ulp en (0, 1])
+inline double log_rapido(double u) {
+    const uint64_t b = std::bit_cast<uint64_t>(u);
+    double e = entero_a_double(b >> 52) - 1023.0;
+    double m = std::bit_cast<double>((b & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);  // [1, 2)
+
+    // Llevar la mantisa a [sqrt(1/2), sqrt(2))
+    const double mayor = m > 1.4142135623730951 ? 1.0 : 0.0;
+    m = m * (1.0 - 0.5 * mayor);
+    e = e + mayor;
+
+    // log(m) = 2 atanh(s), s = (m - 1) / (m + 1), |s| < 0.1716
+    const double s = (m - 1.0) / (m + 1.0);
+    const double s2 = s * s;
+    double p = 1.0 / 21.0;
+    p = p * s2 + 1.0 / 19.0;
+    p = p * s2 + 1.0 / 17.0;
+    p = p * s2 + 1.0 / 15.0;
+    p = p * s2 + 1.0 / 13.0;
+    p = p * s2 + 1.0 / 11.0;
+    p = p * s2 + 1.0 / 9.0;
+    p = p * s2 + 1.0 / 7.0;
+    p = p * s2 + 1.0 / 5.0;
+    p = p * s2 + 1.0 / 3.0;
+    p = p * s2 + 1.0;
+
+    return e * 0.6931471805599453 + 2.0 * s * p;
+}
+
+// cos(2*pi*u) para u en [0, 1)
+inline double cos_2pi(double u) {
+    // cos(2πu) = -cos(2πt) con t = u - 1/2; reducir |t| a [0, 1/4]
+    const double a = std::fabs(u - 0.5);
+    const bool reflejar = a > 0.25;
+    const double r = reflejar ? 0.5 - a : a;
+
+    // Taylor de cos en [0, π/2] hasta x^20
+    const double x = 6.283185307179586 * r;
+    const double x2 = x * x;
+    double c = 1.0 / 2432902008176640000.0;
+    c = c * x2 - 1.0 / 6402373705728000.0;
+    c = c * x2 + 1.0 / 20922789888000.0;
+    c = c * x2 - 1.0 / 87178291200.0;
+    c = c * x2 + 1.0 / 479001600.0;
+    c = c * x2 - 1.0 / 3628800.0;
+    c = c * x2 + 1.0 / 40320.0;
+    c = c * x2 - 1.0 / 720.0;
+    c = c * x2 + 1.0 / 24.0;
+    c = c * x2 - 0.5;
+    c = c * x2 + 1.0;
+
+    return reflejar ? c : -c;
+}
+
+class GeneradorContador {
+public:
+    explicit GeneradorContador(uint64_t semilla) : clave(mezclar_64(semilla)) {}
+
+    // Clave del flujo `flujo` (p. ej. el índice del escenario simulado)
+    uint64_t flujo(uint64_t flujo) const { return mezclar_64(clave ^ mezclar_64(flujo)); }
+
+    static uint64_t bits(uint64_t clave_flujo, uint64_t contador) {
+        return mezclar_64(clave_flujo + contador * 0xd1b54a32d192ed03ULL);
+    }
+
+    // Uniforme en [0, 1) con 52 bits de resolución
+    static double uniforme(uint64_t clave_flujo, uint64_t contador) {
+        return entero_a_double(bits(clave_flujo, contador) >> 12) * 0x1.0p-52;
+    }
+
+    // Normal estándar por Box-Muller; usa los contadores 2c y 2c+1
+    static double normal(uint64_t clave_flujo, uint64_t contador) {
+        double u1 = 1.0 - uniforme(clave_flujo, 2 * contador);  // (0, 1]
+        double u2 = uniforme(clave_flujo, 2 * contador + 1);
+        return std::sqrt(-2.0 * log_rapido(u1)) * cos_2pi(u2);
+    }
+
+private:
+    uint64_t clave;
+};
@@ -0,0 +1,137 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "index.hpp"
+
+// ============================================================================
+// CURSO COMPILADO
+// ----------------------------------------------------------------------------
+// Representación densa de un curso: los ids y tags se internan una sola vez
+// en índices enteros y los datos numéricos quedan en vectores planos
+// (struct-of-arrays). Un escenario es simplemente un arreglo de notas
+// indexado por la posición de la evaluación en el curso.
+// ============================================================================
+
+// Restricción con sus miembros ya resueltos (índices de evaluaciones)
+struct RestriccionCompilada {
+    TipoRestriccion tipo;
+    double valor_minimo;
+    int tag;                    // Índice del tag objetivo en CursoCompilado::tags
+    std::vector<int> miembros;  // Índices de evaluaciones con el tag, en orden de entrada
+};
+
+struct CursoCompilado {
+    Contexto ctx;
+
+    // Evaluaciones (misma posición que en el vector de entrada)
+    std::vector<std::string> ids;
+    std::vector<double> pesos;
+    std::vector<double> notas_conocidas;  // NaN si está pendiente
+    std::vector<int> pendientes;          // Índices de evaluaciones sin nota
+
+    // Tags internados
+    std::vector<std::string> tags;
+
+    // Restricciones (misma posición que en el vector de entrada)
+    std::vector<std::string> ids_restricciones;
+    std::vector<RestriccionCompilada> restricciones;
+
+    // Restricciones en las que participa cada evaluación
+    std::vector<std::vector<int>> restricciones_por_evaluacion;
+
+    std::unordered_map<std::string, int> indice_evaluacion;
+
+    size_t size() const { return ids.size(); }
+
+    bool es_conocida(int i) const { return !std::isnan(notas_conocidas[i]); }
+
+    // Índice de una evaluación por id, -1 si no existe
+    int indice(const std::string& id) const {
+        auto it = indice_evaluacion.find(id);
+        return it == indice_evaluacion.end() ? -1 : it->second;
+    }
+
+    // Reemplaza las notas conocidas (NaN = pendiente) sin tocar la estructura
+    // del curso; reutiliza la memoria de `pendientes`
+    void asignar_notas(std::span<const double> notas) {
+        pendientes.clear();
+        for (size_t i = 0; i < ids.size(); ++i) {
+            notas_conocidas[i] = notas[i];
+            if (std::isnan(notas[i])) pendientes.push_back(static_cast<int>(i));
+        }
+    }
+
+    // Escenario base: notas conocidas y `relleno` en las pendientes
+    void llenar_escenario(std::span<double> escenario, double relleno) const {
+        for (size_t i = 0; i < ids.size(); ++i) {
+            escenario[i] = std::isnan(notas_conocidas[i]) ? relleno : notas_conocidas[i];
+        }
+    }
+};
+
+inline CursoCompilado compilar_curso(const Contexto& ctx,
+                                     const std::vector<Evaluacion>& evaluaciones,
+                                     const std::vector<Restriccion>& restricciones) {
+    CursoCompilado curso;
+    curso.ctx = ctx;
+
+    const size_t n = evaluaciones.size();
+    curso.ids.reserve(n);
+    curso.pesos.reserve(n);
+    curso.notas_conocidas.reserve(n);
+    curso.restricciones_por_evaluacion.resize(n);
+
+    std::unordered_map<std::string, int> indice_tag;
+    std::vector<std::vector<int>> evaluaciones_por_tag;
+
+    auto internar_tag = [&](const std::string& tag) {
+        auto [it, nuevo] = indice_tag.try_emplace(tag, static_cast<int>(curso.tags.size()));
+        if (nuevo) {
+            curso.tags.push_back(tag);
+            evaluaciones_por_tag.emplace_back();
+        }
+        return it->second;
+    };
+
+    for (size_t i = 0; i < n; ++i) {
+        const auto& eval = evaluaciones[i];
+        const int idx = static_cast<int>(i);
+
+        curso.ids.push_back(eval.id);
+        curso.pesos.push_back(eval.peso);
+        curso.notas_conocidas.push_back(
+            eval.valor_actual.value_or(std::numeric_limits<double>::quiet_NaN()));
+        if (!eval.valor_actual.has_value()) curso.pendientes.push_back(idx);
+        curso.indice_evaluacion.try_emplace(eval.id, idx);
+
+        for (const auto& tag : eval.tags) {
+            auto& miembros = evaluaciones_por_tag[internar_tag(tag)];
+            // Un tag repetido en la misma evaluación cuenta una sola vez
+            if (miembros.empty() || miembros.back() != idx) miembros.push_back(idx);
+        }
+    }
+
+    curso.restricciones.reserve(restricciones.size());
+    for (size_t r = 0; r < restricciones.size(); ++r) {
+        const auto& res = restricciones[r];
+        RestriccionCompilada rc;
+        rc.tipo = res.tipo;
+        rc.valor_minimo = res.valor_minimo;
+        rc.tag = internar_tag(res.tag_objetivo);
+        rc.miembros = evaluaciones_por_tag[rc.tag];
+
+        for (int m : rc.miembros) {
+            curso.restricciones_por_evaluacion[m].push_back(static_cast<int>(r));
+        }
+
+        curso.ids_restricciones.push_back(res.id);
+        curso.restricciones.push_back(std::move(rc));
+    }
+
+    return curso;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+
+// ============================================================================
+// UTILIDADES ESTADÍSTICAS
+// ============================================================================
+
+// Cuantil de la normal estándar (aproximación racional de Acklam, error
+// relativo < 1.2e-9), para 0 < p < 1
+inline double cuantil_normal(double p) {
+    static constexpr double a[] = { -3.969683028665376e+01,  2.209460984245205e+02,
+                                    -2.759285104469687e+02,  1.383577518672690e+02,
+                                    -3.066479806614716e+01,  2.506628277459239e+00 };
+    static constexpr double b[] = { -5.447609879822406e+01,  1.615858368580409e+02,
+                                    -1.556989798598866e+02,  6.680131188771972e+01,
+                                    -1.328068155288572e+01 };
+    static constexpr double c[] = { -7.784894002430293e-03, -3.223964580411365e-01,
+                                    -2.400758277161838e+00, -2.549732539343734e+00,
+                                     4.374664141464968e+00,  2.938163982698783e+00 };
+    static constexpr double d[] = {  7.784695709041462e-03,  3.224671290700398e-01,
+                                     2.445134137142996e+00,  3.754408661907416e+00 };
+    constexpr double p_bajo = 0.02425;
+
+    if (p < p_bajo) {
+        double q = std::sqrt(-2.0 * std::log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    if (p > 1.0 - p_bajo) {
+        double q = std::sqrt(-2.0 * std::log(1.0 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+}
+
+// Valor z de un intervalo bilateral con el nivel de confianza dado (p. ej. 0.95)
+inline double z_confianza(double confianza) {
+    return cuantil_normal(0.5 + confianza / 2.0);
+}
+
+// Valor crítico t de Student bilateral con `grados` grados de libertad
+// (expansión de Cornish-Fisher alrededor de la normal; suficiente desde ~5)
+inline double t_confianza(double confianza, int grados) {
+    const double z = z_confianza(confianza);
+    const double nu = static_cast<double>(grados);
+    const double z3 = z * z * z, z5 = z3 * z * z;
+    return z + (z3 + z) / (4.0 * nu) + (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * nu * nu);
+}
+
+struct IntervaloConfianza {
+    double inferior = 0.0;
+    double superior = 1.0;
+
+    double semiancho() const { return (superior - inferior) / 2.0; }
+};
+
+// Intervalo de Wilson para una proporción de `exitos` en `n` ensayos. Sin
+// ensayos devuelve [0, 1].
+inline IntervaloConfianza intervalo_wilson(long long exitos, long long n, double z) {
+    if (n <= 0) return {};
+
+    const double nn = static_cast<double>(n);
+    const double p = static_cast<double>(exitos) / nn;
+    const double z2 = z * z;
+    const double centro = (p + z2 / (2.0 * nn)) / (1.0 + z2 / nn);
+    const double margen = z * std::sqrt(p * (1.0 - p) / nn + z2 / (4.0 * nn * nn)) / (1.0 + z2 / nn);
+
+    return { std::max(0.0, centro - margen), std::min(1.0, centro + margen) };
+}
@@ -0,0 +1,254 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <variant>
+#include <vector>
+#include "curso_compilado.hpp"
+
+// ============================================================================
+// EVALUACIÓN DE ESCENARIOS
+// ----------------------------------------------------------------------------
+// Cada tipo de chequeo es un tipo concreto con su propio `cumple`; el tipo
+// de restricción se resuelve al armar el chequeo y no en cada evaluación.
+// Los chequeos solo guardan vistas a la memoria del CursoCompilado, así que
+// evaluar un escenario no reserva memoria. El curso debe vivir más que los
+// chequeos creados a partir de él.
+//
+// Además de un escenario suelto, cada chequeo evalúa un bloque de hasta
+// ANCHO_BLOQUE escenarios guardados por columnas (notas[i * ANCHO_BLOQUE + j]
+// es la nota de la evaluación i en el escenario j) y apaga `vivo[j]` en los
+// escenarios que no cumplen. Los ciclos internos recorren escenarios, así que
+// el compilador los vectoriza; el resultado por escenario es idéntico al de
+// la versión escalar.
+// ============================================================================
+
+inline constexpr size_t ANCHO_BLOQUE = 64;
+
+// Promedio ponderado total >= nota de aprobación
+struct ChequeoPromedioGlobal {
+    std::span<const double> pesos;
+    double minimo;
+
+    bool cumple(std::span<const double> escenario) const {
+        double total = 0.0;
+        for (size_t i = 0; i < pesos.size(); ++i) {
+            total += escenario[i] * pesos[i];
+        }
+        return total >= minimo;
+    }
+
+    void cumple_bloque(const double* notas, size_t ancho, uint8_t* vivo) const {
+        double total[ANCHO_BLOQUE] = {};
+        for (size_t i = 0; i < pesos.size(); ++i) {
+            const double* fila = notas + i * ANCHO_BLOQUE;
+            for (size_t j = 0; j < ancho; ++j) total[j] += fila[j] * pesos[i];
+        }
+        for (size_t j = 0; j < ancho; ++j) vivo[j] &= total[j] >= minimo;
+    }
+
+    size_t costo() const { return pesos.size(); }
+};
+
+// Una especialización por cada TipoRestriccion
+template <TipoRestriccion T>
+struct ChequeoTag;
+
+template <>
+struct ChequeoTag<TipoRestriccion::PROMEDIO_SIMPLE_TAG> {
+    std::span<const int> miembros;
+    double minimo;
+
+    bool cumple(std::span<const double> escenario) const {
+        if (miembros.empty()) return true;
+        double suma = 0;
+        for (int m : miembros) suma += escenario[m];
+        return (suma / miembros.size()) >= minimo;
+    }
+
+    void cumple_bloque(const double* notas, size_t ancho, uint8_t* vivo) const {
+        if (miembros.empty()) return;
+        double suma[ANCHO_BLOQUE] = {};
+        for (int m : miembros) {
+            const double* fila = notas + m * ANCHO_BLOQUE;
+            for (size_t j = 0; j < ancho; ++j) suma[j] += fila[j];
+        }
+        const double n = static_cast<double>(miembros.size());
+        for (size_t j = 0; j < ancho; ++j) vivo[j] &= (suma[j] / n) >= minimo;
+    }
+
+    size_t costo() const { return miembros.size(); }
+};
+
+template <>
+struct ChequeoTag<TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG> {
+    std::span<const int> miembros;
+    double minimo;
+
+    bool cumple(std::span<const double> escenario) const {
+        for (int m : miembros) if (escenario[m] < minimo) return false;
+        return true;
+    }
+
+    void cumple_bloque(const double* notas, size_t ancho, uint8_t* vivo) const {
+        for (int m : miembros) {
+            const double* fila = notas + m * ANCHO_BLOQUE;
+            for (size_t j = 0; j < ancho; ++j) vivo[j] &= fila[j] >= minimo;
+        }
+    }
+
+    size_t costo() const { return miembros.size(); }
+};
+
+using Chequeo = std::variant<
+    ChequeoPromedioGlobal,
+    ChequeoTag<TipoRestriccion::PROMEDIO_SIMPLE_TAG>,
+    ChequeoTag<TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG>
+>;
+
+inline Chequeo crear_chequeo(const RestriccionCompilada& res) {
+    switch (res.tipo) {
+        case TipoRestriccion::PROMEDIO_SIMPLE_TAG:
+            return ChequeoTag<TipoRestriccion::PROMEDIO_SIMPLE_TAG> { res.miembros, res.valor_minimo };
+        case TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG:
+            return ChequeoTag<TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG> { res.miembros, res.valor_minimo };
+    }
+    // Tipo desconocido: nunca falla
+    return ChequeoTag<TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG> { {}, 0.0 };
+}
+
+inline bool cumple(const Chequeo& chequeo, std::span<const double> escenario) {
+    return std::visit([&](const auto& c) { return c.cumple(escenario); }, chequeo);
+}
+
+inline void cumple_bloque(const Chequeo& chequeo, const double* notas, size_t ancho, uint8_t* vivo) {
+    std::visit([&](const auto& c) { c.cumple_bloque(notas, ancho, vivo); }, chequeo);
+}
+
+inline size_t costo(const Chequeo& chequeo) {
+    return std::visit([](const auto& c) { return c.costo(); }, chequeo);
+}
+
+// ============================================================================
+// Funciones directas (orden fijo: promedio global y luego restricciones)
+// ============================================================================
+
+// Promedio ponderado total del escenario
+inline double promedio_ponderado(const CursoCompilado& curso, std::span<const double> escenario) {
+    double total = 0.0;
+    for (size_t i = 0; i < curso.pesos.size(); ++i) {
+        total += escenario[i] * curso.pesos[i];
+    }
+    return total;
+}
+
+inline bool evaluar_restriccion(const RestriccionCompilada& res, std::span<const double> escenario) {
+    return cumple(crear_chequeo(res), escenario);
+}
+
+// ¿El escenario cumple el promedio de aprobación y todas las restricciones?
+inline bool validar_escenario(const CursoCompilado& curso, std::span<const double> escenario) {
+    if (promedio_ponderado(curso, escenario) < curso.ctx.nota_aprobacion) return false;
+
+    for (const auto& res : curso.restricciones) {
+        if (!evaluar_restriccion(res, escenario)) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// EVALUADOR ADAPTATIVO
+// ----------------------------------------------------------------------------
+// Para validar muchos escenarios seguidos (Monte Carlo). Lleva la tasa de
+// fallo observada de cada chequeo y cada cierto número de validaciones los
+// reordena por tasa de fallo / costo, de modo que un escenario rechazado
+// sale tras el chequeo más barato y selectivo. El resultado no depende del
+// orden: solo cambia cuántos chequeos se evalúan antes de rechazar.
+// Un evaluador por hilo.
+// ============================================================================
+
+class EvaluadorEscenarios {
+public:
+    explicit EvaluadorEscenarios(const CursoCompilado& curso) {
+        chequeos.reserve(curso.restricciones.size() + 1);
+        agregar(ChequeoPromedioGlobal { curso.pesos, curso.ctx.nota_aprobacion });
+        for (const auto& res : curso.restricciones) {
+            agregar(crear_chequeo(res));
+        }
+    }
+
+    bool validar(std::span<const double> escenario) {
+        bool aprueba = true;
+        for (auto& e : chequeos) {
+            e.evaluados++;
+            if (!cumple(e.chequeo, escenario)) {
+                e.fallas++;
+                aprueba = false;
+                break;
+            }
+        }
+
+        if (++validaciones >= proximo_reordenamiento) reordenar();
+        return aprueba;
+    }
+
+    // Valida un bloque de `ancho` escenarios por columnas (ver ANCHO_BLOQUE);
+    // deja vivo[j] = 1 si el escenario j aprueba. Devuelve cuántos aprueban.
+    size_t validar_bloque(const double* notas, size_t ancho, uint8_t* vivo) {
+        for (size_t j = 0; j < ancho; ++j) vivo[j] = 1;
+
+        size_t vivos = ancho;
+        for (auto& e : chequeos) {
+            if (vivos == 0) break;
+            e.evaluados += static_cast<uint32_t>(vivos);
+            cumple_bloque(e.chequeo, notas, ancho, vivo);
+
+            size_t quedan = 0;
+            for (size_t j = 0; j < ancho; ++j) quedan += vivo[j];
+            e.fallas += static_cast<uint32_t>(vivos - quedan);
+            vivos = quedan;
+        }
+
+        validaciones += ancho;
+        if (validaciones >= proximo_reordenamiento) reordenar();
+        return vivos;
+    }
+
+private:
+    struct Entrada {
+        Chequeo chequeo;
+        double costo;
+        uint32_t evaluados = 0;
+        uint32_t fallas = 0;
+
+        // Fallos esperados por unidad de costo (con un prior suave)
+        double prioridad() const { return (fallas + 1.0) / ((evaluados + 2.0) * costo); }
+    };
+
+    std::vector<Entrada> chequeos;
+    uint64_t validaciones = 0;
+    uint64_t intervalo = 256;
+    uint64_t proximo_reordenamiento = 256;
+
+    // Intervalo máximo entre reordenamientos
+    static constexpr uint64_t INTERVALO_MAXIMO = 65536;
+
+    void agregar(Chequeo chequeo) {
+        double c = static_cast<double>(std::max<size_t>(1, costo(chequeo)));
+        chequeos.push_back(Entrada { std::move(chequeo), c });
+    }
+
+    void reordenar() {
+        std::stable_sort(chequeos.begin(), chequeos.end(),
+                         [](const Entrada& a, const Entrada& b) { return a.prioridad() > b.prioridad(); });
+
+        // Olvidar la mitad de la historia para seguir adaptándose
+        for (auto& e : chequeos) {
+            e.evaluados /= 2;
+            e.fallas /= 2;
+        }
+
+        intervalo = std::min(intervalo * 2, INTERVALO_MAXIMO);
+        proximo_reordenamiento = validaciones + intervalo;
+    }
+};
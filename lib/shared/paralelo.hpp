@@ -0,0 +1,78 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// En WASM sin pthreads no hay hilos: todo corre en el hilo que llama
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define GRADESOLVER_SIN_HILOS 1
+#endif
+
+// Normaliza la cantidad de hilos pedida: 0 = todos los núcleos, 1 = serial
+inline int resolver_hilos(int hilos) {
+#ifdef GRADESOLVER_SIN_HILOS
+    (void)hilos;
+    return 1;
+#else
+    if (hilos <= 0) {
+        unsigned int nucleos = std::thread::hardware_concurrency();
+        return nucleos > 0 ? static_cast<int>(nucleos) : 1;
+    }
+    return hilos;
+#endif
+}
+
+// Reparte [0, n) en bloques contiguos y llama f(inicio, fin) en cada hilo.
+// Cada bloque tiene al menos `min_por_hilo` elementos para no pagar el costo
+// de crear hilos con poco trabajo. El bloque 0 corre en el hilo que llama.
+// Si algún bloque lanza, se espera a todos los hilos y se relanza la primera
+// excepción en orden de bloque.
+template <typename F>
+void ejecutar_en_paralelo(size_t n, int hilos, size_t min_por_hilo, F&& f) {
+    if (n == 0) return;
+
+    size_t bloques = static_cast<size_t>(resolver_hilos(hilos));
+    bloques = std::min(bloques, std::max<size_t>(1, n / std::max<size_t>(1, min_por_hilo)));
+
+    if (bloques <= 1) {
+        f(size_t{0}, n);
+        return;
+    }
+
+#ifndef GRADESOLVER_SIN_HILOS
+    const size_t tam = n / bloques, resto = n % bloques;
+    auto limites = [&](size_t b) {
+        size_t inicio = b * tam + std::min(b, resto);
+        return std::pair<size_t, size_t>{ inicio, inicio + tam + (b < resto ? 1 : 0) };
+    };
+
+    std::vector<std::exception_ptr> errores(bloques);
+    auto correr = [&f, &errores, &limites](size_t b) {
+        try {
+            auto [inicio, fin] = limites(b);
+            f(inicio, fin);
+        } catch (...) {
+            errores[b] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> trabajadores;
+    trabajadores.reserve(bloques - 1);
+    try {
+        for (size_t b = 1; b < bloques; ++b) trabajadores.emplace_back(correr, b);
+    } catch (...) {
+        // No se pudo crear un hilo: los bloques que faltan corren aquí
+        for (size_t b = trabajadores.size() + 1; b < bloques; ++b) correr(b);
+    }
+
+    correr(0);
+
+    for (auto& t : trabajadores) t.join();
+    for (auto& error : errores) {
+        if (error) std::rethrow_exception(error);
+    }
+#endif
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// ============================================================================
+// SECUENCIA DE SOBOL
+// ----------------------------------------------------------------------------
+// Puntos de baja discrepancia en [0, 1)^d con 32 bits por coordenada. La
+// primera dimensión es van der Corput; las siguientes usan los números de
+// dirección de Joe y Kuo (new-joe-kuo-6.21201). Cualquier punto se calcula
+// directamente a partir de su índice, así que se pueden repartir entre hilos
+// sin estado compartido.
+// ============================================================================
+
+class SecuenciaSobol {
+public:
+    static constexpr int MAX_DIMENSIONES = 32;
+
+    explicit SecuenciaSobol(int dimensiones) : direcciones(dimensiones) {
+        for (int k = 0; k < 32; ++k) direcciones[0][k] = 1u << (31 - k);
+
+        for (int d = 1; d < dimensiones; ++d) {
+            const auto& p = POLINOMIOS[d - 1];
+            auto& v = direcciones[d];
+            for (int k = 0; k < p.s; ++k) v[k] = p.m[k] << (31 - k);
+            for (int k = p.s; k < 32; ++k) {
+                uint32_t x = v[k - p.s] ^ (v[k - p.s] >> p.s);
+                for (int j = 1; j < p.s; ++j) {
+                    if ((p.a >> (p.s - 1 - j)) & 1u) x ^= v[k - j];
+                }
+                v[k] = x;
+            }
+        }
+    }
+
+    int dimensiones() const { return static_cast<int>(direcciones.size()); }
+
+    // Coordenada `d` del punto `i` (sin aleatorizar)
+    uint32_t punto(uint64_t i, int d) const {
+        const auto& v = direcciones[d];
+        uint32_t x = 0;
+        for (int k = 0; i != 0 && k < 32; ++k, i >>= 1) {
+            if (i & 1u) x ^= v[k];
+        }
+        return x;
+    }
+
+private:
+    struct Polinomio {
+        int s;          // Grado
+        uint32_t a;     // Coeficientes interiores
+        uint32_t m[7];  // Números de dirección iniciales
+    };
+
+    // Dimensiones 2..32 de new-joe-kuo-6.21201
+    static constexpr Polinomio POLINOMIOS[MAX_DIMENSIONES - 1] = {
+        { 1,  0, { 1 } },
+        { 2,  1, { 1, 3 } },
+        { 3,  1, { 1, 3, 1 } },
+        { 3,  2, { 1, 1, 1 } },
+        { 4,  1, { 1, 1, 3, 3 } },
+        { 4,  4, { 1, 3, 5, 13 } },
+        { 5,  2, { 1, 1, 5, 5, 17 } },
+        { 5,  4, { 1, 1, 5, 5, 5 } },
+        { 5,  7, { 1, 1, 7, 11, 19 } },
+        { 5, 11, { 1, 1, 5, 1, 1 } },
+        { 5, 13, { 1, 1, 1, 3, 11 } },
+        { 5, 14, { 1, 3, 5, 5, 31 } },
+        { 6,  1, { 1, 3, 3, 9, 7, 49 } },
+        { 6, 13, { 1, 1, 1, 15, 21, 21 } },
+        { 6, 16, { 1, 3, 1, 13, 27, 49 } },
+        { 6, 19, { 1, 1, 1, 15, 7, 5 } },
+        { 6, 22, { 1, 3, 1, 15, 13, 25 } },
+        { 6, 25, { 1, 1, 5, 5, 19, 61 } },
+        { 7,  1, { 1, 3, 7, 11, 23, 15, 103 } },
+        { 7,  4, { 1, 3, 7, 13, 13, 15, 69 } },
+        { 7,  7, { 1, 1, 3, 13, 7, 35, 63 } },
+        { 7,  8, { 1, 3, 5, 9, 1, 25, 53 } },
+        { 7, 14, { 1, 3, 1, 13, 9, 35, 107 } },
+        { 7, 19, { 1, 3, 1, 5, 27, 61, 31 } },
+        { 7, 21, { 1, 1, 5, 11, 19, 41, 61 } },
+        { 7, 28, { 1, 3, 5, 3, 3, 13, 69 } },
+        { 7, 31, { 1, 1, 7, 13, 1, 19, 1 } },
+        { 7, 32, { 1, 3, 7, 5, 13, 19, 59 } },
+        { 7, 37, { 1, 1, 3, 9, 25, 29, 41 } },
+        { 7, 41, { 1, 3, 5, 13, 23, 1, 55 } },
+        { 7, 42, { 1, 3, 7, 3, 13, 59, 17 } },
+    };
+
+    std::vector<std::array<uint32_t, 32>> direcciones;
+};
+
+// Revoltura anidada uniforme (estilo Owen) por hash, de Burley (2020):
+// permuta cada coordenada de forma que se conserva la estructura de la red
+// y el punto queda uniforme en [0, 1). Una semilla por dimensión y réplica.
+inline uint32_t invertir_bits(uint32_t x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+    x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+inline uint32_t revolver_owen(uint32_t x, uint32_t semilla) {
+    x = invertir_bits(x);
+    x += semilla;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return invertir_bits(x);
+}
@@ -0,0 +1,97 @@
+#!/usr/bin/env node
+"use strict";
+
+// Mide el arranque en frío del paquete WASM: cada corrida es un proceso de
+// Node nuevo que carga el paquete, instancia el módulo y resuelve un caso.
+//
+//   node scripts/bench_arranque.js [dir_paquete] [corridas]
+//
+// Por defecto usa dist/js y 10 corridas por variante. Reporta la mediana y el
+// peor caso de cada etapa, en ms desde que arranca el proceso hijo.
+
+const { execFileSync } = require("child_process");
+const fs = require("fs");
+const path = require("path");
+
+const raiz = path.join(__dirname, "..");
+const paquete = path.resolve(process.argv[2] ?? path.join(raiz, "dist/js"));
+const corridas = Math.max(1, Number(process.argv[3] ?? 10));
+const caso = path.join(raiz, "tests/cases/01-basic.json");
+
+if (!fs.existsSync(path.join(paquete, "index.js"))) {
+  console.error(`No se encontró ${path.join(paquete, "index.js")}; ejecuta primero: make wasm`);
+  process.exit(1);
+}
+
+// Corre dentro del proceso hijo; imprime los tiempos como JSON
+const hijo = `
+const inicio = performance.now();
+const solver = require(process.env.PAQUETE);
+const carga = performance.now();
+solver.wasmVariant().then(async (variante) => {
+  const instancia = performance.now();
+  const entrada = require("fs").readFileSync(process.env.CASO, "utf8");
+  await solver.solve(entrada);
+  const primero = performance.now();
+  await solver.solve(entrada);
+  const segundo = performance.now();
+
+  const pool = solver.createPool({ size: 4 });
+  const antesPool = performance.now();
+  await Promise.all([0, 1, 2, 3].map(() => pool.solve(entrada)));
+  const conPool = performance.now();
+  await pool.close();
+
+  console.log(JSON.stringify({
+    variante,
+    carga: carga - inicio,
+    instancia: instancia - carga,
+    primer_solve: primero - instancia,
+    solve_caliente: segundo - primero,
+    total: primero - inicio,
+    pool_4: conPool - antesPool,
+    rss_mb: process.memoryUsage().rss / 2 ** 20,
+  }));
+});
+`;
+
+function variantesDisponibles() {
+  const lista = ["base"];
+  for (const variante of ["simd", "hilos"]) {
+    if (fs.existsSync(path.join(paquete, variante, "node", "solver.js"))) lista.push(variante);
+  }
+  return lista;
+}
+
+function resumen(valores) {
+  const ordenados = [...valores].sort((a, b) => a - b);
+  return { mediana: ordenados[Math.floor(ordenados.length / 2)], peor: ordenados[ordenados.length - 1] };
+}
+
+const columnas = ["carga", "instancia", "primer_solve", "total", "solve_caliente", "pool_4", "rss_mb"];
+
+console.log(`Paquete: ${paquete}`);
+console.log(`Corridas por variante: ${corridas}\n`);
+console.log(["variante", ...columnas].map((c) => c.padStart(16)).join(""));
+
+for (const variante of variantesDisponibles()) {
+  const muestras = [];
+  for (let i = 0; i < corridas; i++) {
+    const salida = execFileSync(process.execPath, ["-e", hijo], {
+      env: { ...process.env, PAQUETE: paquete, CASO: caso, GRADESOLVER_WASM: variante },
+      encoding: "utf8",
+    });
+    muestras.push(JSON.parse(salida.trim().split("\n").pop()));
+  }
+
+  // La variante que se cargó de verdad (si no está soportada cae a la base)
+  const cargada = muestras[0].variante;
+  const celdas = columnas.map((columna) => {
+    const { mediana, peor } = resumen(muestras.map((m) => m[columna]));
+    return `${mediana.toFixed(1)}/${peor.toFixed(1)}`.padStart(16);
+  });
+  const nombre = cargada === variante ? variante : `${variante}->${cargada}`;
+  console.log(nombre.padStart(16) + celdas.join(""));
+}
+
+console.log("\nmediana/peor en ms (rss_mb en MB)");
@@ -16,28 +16,41 @@ fi
 echo "Emscripten version:"
 emcc --version
 
-# Crear directorio de build para WASM si no existe
-BUILD_DIR="build_wasm"
-if [ -d "$BUILD_DIR" ]; then
-    echo "Limpiando build anterior..."
-    rm -rf "$BUILD_DIR"
-fi
+# velocidad (por defecto) o tamano: -Oz y LTO, para arranques en frío
+PERFIL="${GRADESOLVER_WASM_PERFIL:-velocidad}"
+echo "Perfil: $PERFIL"
 
-mkdir -p "$BUILD_DIR"
-cd "$BUILD_DIR"
+# Una build por variante: las flags de SIMD y pthreads afectan a todo el
+# código, no solo al binding
+build_variante() {
+    local variante="$1"
+    local build_dir="$2"
 
-echo ""
-echo "Configurando con CMake..."
-emcmake cmake .. \
-    -DCMAKE_BUILD_TYPE=Release \
-    -DCMAKE_CXX_STANDARD=20
+    if [ -d "$build_dir" ]; then
+        echo "Limpiando build anterior ($variante)..."
+        rm -rf "$build_dir"
+    fi
+    mkdir -p "$build_dir"
 
-echo ""
-echo "Compilando..."
-emmake make solver_wasm_node solver_wasm_web -j4
+    echo ""
+    echo "Configurando con CMake (variante $variante)..."
+    emcmake cmake -S . -B "$build_dir" \
+        -DCMAKE_BUILD_TYPE=Release \
+        -DCMAKE_CXX_STANDARD=20 \
+        -DGRADESOLVER_WASM_VARIANTE="$variante" \
+        -DGRADESOLVER_WASM_PERFIL="$PERFIL"
+
+    echo ""
+    echo "Compilando (variante $variante)..."
+    emmake make -C "$build_dir" solver_wasm_node solver_wasm_web -j4
+}
+
+BUILD_DIR="build_wasm"
+build_variante base "$BUILD_DIR"
+build_variante simd "${BUILD_DIR}_simd"
+build_variante hilos "${BUILD_DIR}_hilos"
 
 # Crear directorio dist si no existe
-cd ..
 mkdir -p dist
 mkdir -p dist/js
 
@@ -48,9 +61,21 @@ cp "$BUILD_DIR"/binding/node/solver.js dist/js/solver.js
 cp "$BUILD_DIR"/binding/node/solver.wasm dist/js/solver.wasm
 cp "$BUILD_DIR"/binding/web/solver.mjs dist/js/solver.web.mjs
 cp "$BUILD_DIR"/binding/web/solver.wasm dist/js/solver.web.wasm
+
+# Las variantes van en su propio directorio y con los nombres que generó
+# emscripten: con pthreads cada worker vuelve a cargar el script por ese nombre
+for variante in simd hilos; do
+    rm -rf "dist/js/$variante"
+    mkdir -p "dist/js/$variante"
+    cp -R "${BUILD_DIR}_$variante"/binding/node "dist/js/$variante/node"
+    cp -R "${BUILD_DIR}_$variante"/binding/web "dist/js/$variante/web"
+done
+
 cp binding/js/solver.d.ts dist/js/solver.d.ts
 cp binding/js/index.js dist/js/index.js
 cp binding/js/index.mjs dist/js/index.mjs
+cp binding/js/pool.js dist/js/pool.js
+cp binding/js/pool_worker.js dist/js/pool_worker.js
 cp binding/js/package.json dist/js/package.json
 
 echo ""
@@ -63,6 +88,8 @@ echo "  - dist/js/solver.js"
 echo "  - dist/js/solver.wasm"
 echo "  - dist/js/solver.web.mjs"
 echo "  - dist/js/solver.web.wasm"
+echo "  - dist/js/simd/{node,web}/   (SIMD128)"
+echo "  - dist/js/hilos/{node,web}/  (SIMD128 + pthreads)"
 echo "  - dist/js/solver.d.ts"
 echo "  - dist/js/package.json"
 echo ""
@@ -41,8 +41,14 @@ mkdir -p "$PKG_DIR"
 cp "$BINDING_DIR/package.json" "$PKG_DIR/"
 cp "$BINDING_DIR/solver.d.ts" "$PKG_DIR/"
 cp "$BINDING_DIR/index.js" "$PKG_DIR/"
+cp "$BINDING_DIR/pool.js" "$BINDING_DIR/pool_worker.js" "$PKG_DIR/"
 cp "$DIST_DIR/solver.js" "$PKG_DIR/"
 cp "$DIST_DIR/solver.wasm" "$PKG_DIR/"
+for variante in simd hilos; do
+  if [ -d "$DIST_DIR/$variante" ]; then
+    cp -R "$DIST_DIR/$variante" "$PKG_DIR/"
+  fi
+done
 
 echo ""
 echo "Empaquetando..."
@@ -0,0 +1,80 @@
+#pragma once
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <vector>
+
+// Mini marco de pruebas sin dependencias: cada CASO se registra solo al
+// cargar el ejecutable y correr_pruebas() los ejecuta en orden de
+// declaración. Una verificación fallida se reporta y el caso sigue.
+
+struct CasoPrueba {
+    const char* nombre;
+    void (*cuerpo)();
+};
+
+inline std::vector<CasoPrueba>& casos_prueba() {
+    static std::vector<CasoPrueba> casos;
+    return casos;
+}
+
+inline int& fallas_prueba() {
+    static int fallas = 0;
+    return fallas;
+}
+
+struct RegistroCaso {
+    RegistroCaso(const char* nombre, void (*cuerpo)()) { casos_prueba().push_back({ nombre, cuerpo }); }
+};
+
+#define CASO(nombre)                                           \
+    static void nombre();                                      \
+    static RegistroCaso registro_##nombre(#nombre, nombre);    \
+    static void nombre()
+
+#define VERIFICAR(condicion)                                                              \
+    do {                                                                                  \
+        if (!(condicion)) {                                                               \
+            std::fprintf(stderr, "  %s:%d: falla: %s\n", __FILE__, __LINE__, #condicion); \
+            fallas_prueba()++;                                                            \
+        }                                                                                 \
+    } while (0)
+
+#define VERIFICAR_CERCA(a, b, tolerancia)                                                      \
+    do {                                                                                       \
+        double va_ = (a), vb_ = (b);                                                           \
+        if (!(std::abs(va_ - vb_) <= (tolerancia))) {                                          \
+            std::fprintf(stderr, "  %s:%d: falla: %s = %.17g, %s = %.17g (tolerancia %g)\n",  \
+                         __FILE__, __LINE__, #a, va_, #b, vb_, static_cast<double>(tolerancia)); \
+            fallas_prueba()++;                                                                 \
+        }                                                                                      \
+    } while (0)
+
+#define VERIFICAR_LANZA(expresion, Tipo)                                                       \
+    do {                                                                                       \
+        bool lanzo_ = false;                                                                   \
+        try { (void)(expresion); } catch (const Tipo&) { lanzo_ = true; }                      \
+        if (!lanzo_) {                                                                         \
+            std::fprintf(stderr, "  %s:%d: falla: %s no lanzó %s\n", __FILE__, __LINE__,        \
+                         #expresion, #Tipo);                                                   \
+            fallas_prueba()++;                                                                 \
+        }                                                                                      \
+    } while (0)
+
+inline int correr_pruebas() {
+    int casos_fallidos = 0;
+    for (const auto& caso : casos_prueba()) {
+        int antes = fallas_prueba();
+        try {
+            caso.cuerpo();
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "  excepción: %s\n", e.what());
+            fallas_prueba()++;
+        }
+        bool paso = fallas_prueba() == antes;
+        if (!paso) casos_fallidos++;
+        std::printf("[%s] %s\n", paso ? " OK " : "FALLA", caso.nombre);
+    }
+    std::printf("\n%zu casos, %d fallidos\n", casos_prueba().size(), casos_fallidos);
+    return casos_fallidos == 0 ? 0 : 1;
+}
@@ -0,0 +1,243 @@
+#include "prueba.hpp"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using json = nlohmann::json;
+
+// API C de libgradesolver_api (binding/binding_api.cpp)
+extern "C" {
+const char* solve_process(const char* input_json_raw);
+const char* solve_batch(const char* input_raw);
+void* solve_process_r(const char* input_json_raw);
+int solve_process_en(const char* input_json_raw, char* buffer, size_t capacidad, size_t* largo);
+void* solve_batch_r(const char* input_raw);
+const char* resultado_datos(const void* resultado);
+void resultado_liberar(void* resultado);
+void solver_configurar_hilos(int hilos);
+void solver_limpiar_cache();
+void* solver_crear(int hilos);
+const char* solver_resolver(void* handle, const char* input_json_raw);
+void solver_destruir(void* handle);
+void* sesion_crear(const char* input_json_raw);
+int sesion_set_grade(void* handle, const char* id, double valor);
+int sesion_clear_grade(void* handle, const char* id);
+int sesion_es_posible(void* handle);
+const double* sesion_rango(void* handle, const char* id);
+const char* sesion_resultado(void* handle);
+void sesion_destruir(void* handle);
+}
+
+// ============================================================================
+// LOTES
+// ----------------------------------------------------------------------------
+// solve_batch debe devolver, en orden, exactamente lo que devuelve
+// solve_process para cada entrada por separado, tanto con un arreglo JSON
+// como con NDJSON y con cualquier cantidad de hilos. Un error queda en su
+// posición sin afectar a las demás.
+// ============================================================================
+
+namespace {
+
+json curso(uint64_t semilla, double nota_c1, const char* muestreo) {
+    return json{
+        { "contexto", { { "nota_minima", 1.0 }, { "nota_maxima", 7.0 }, { "nota_aprobacion", 4.0 } } },
+        { "evaluaciones", json::array({
+            { { "id", "C1" }, { "peso", 0.3 }, { "valor_actual", nota_c1 }, { "tags", json::array({ "c" }) } },
+            { { "id", "C2" }, { "peso", 0.3 }, { "valor_actual", nullptr }, { "tags", json::array({ "c" }) } },
+            { { "id", "Examen" }, { "peso", 0.4 }, { "valor_actual", nullptr }, { "tags", json::array() } },
+        }) },
+        { "restricciones", json::array({
+            { { "id", "Promedio C" }, { "tipo", "PROMEDIO_SIMPLE_TAG" }, { "tag_objetivo", "c" }, { "valor_minimo", 4.0 } },
+        }) },
+        { "P", { { "simulaciones", 2000 }, { "semilla", semilla }, { "muestreo", muestreo } } },
+    };
+}
+
+// Entradas con semilla (reproducibles) y dos inválidas en medio
+std::vector<std::string> entradas_del_lote() {
+    std::vector<std::string> entradas;
+    const char* muestreos[] = { "MC", "QMC", "IS" };
+    for (int i = 0; i < 12; ++i) {
+        json entrada = curso(100 + i, 1.0 + 0.5 * i, muestreos[i % 3]);
+        if (i % 3 == 2) {
+            entrada["P"]["media_historica"] = 4.5;
+            entrada["P"]["desviacion_estandar"] = 1.0;
+        }
+        entradas.push_back(entrada.dump());
+        if (i == 4) entradas.push_back(curso(7, 4.0, "MCMC").dump());  // Muestreo desconocido
+        if (i == 8) {
+            json negativa = curso(7, 4.0, "MC");
+            negativa["P"]["semilla"] = -7;
+            entradas.push_back(negativa.dump());
+        }
+    }
+    return entradas;
+}
+
+std::string por_separado(const std::vector<std::string>& entradas) {
+    std::string esperado = "[";
+    for (size_t i = 0; i < entradas.size(); ++i) {
+        if (i > 0) esperado += ',';
+        esperado += solve_process(entradas[i].c_str());
+    }
+    return esperado + "]";
+}
+
+} // namespace
+
+CASO(lote_igual_a_llamadas_individuales) {
+    const auto entradas = entradas_del_lote();
+
+    solver_configurar_hilos(1);
+    solver_limpiar_cache();
+    const std::string esperado = por_separado(entradas);
+
+    const json resultados = json::parse(esperado);
+    VERIFICAR(resultados.size() == entradas.size());
+    VERIFICAR(resultados[5].value("status", "") == "error");
+    VERIFICAR(resultados[10].value("status", "") == "error");
+
+    std::string arreglo = "[";
+    std::string ndjson;
+    for (size_t i = 0; i < entradas.size(); ++i) {
+        if (i > 0) arreglo += ",\n";
+        arreglo += entradas[i];
+        ndjson += entradas[i] + "\n\n";  // Las líneas vacías se ignoran
+    }
+    arreglo += "]";
+
+    // Sin cache cada entrada se vuelve a resolver dentro del lote
+    for (int hilos : { 1, 4, 0 }) {
+        solver_configurar_hilos(hilos);
+        solver_limpiar_cache();
+        VERIFICAR(std::string(solve_batch(arreglo.c_str())) == esperado);
+        solver_limpiar_cache();
+        VERIFICAR(std::string(solve_batch(ndjson.c_str())) == esperado);
+
+        void* resultado = solve_batch_r(arreglo.c_str());
+        VERIFICAR(std::string(resultado_datos(resultado)) == esperado);
+        resultado_liberar(resultado);
+    }
+    solver_configurar_hilos(1);
+}
+
+CASO(lote_vacio_y_mal_formado) {
+    VERIFICAR(std::string(solve_batch("[]")) == "[]");
+    VERIFICAR(std::string(solve_batch("")) == "[]");
+
+    // Un arreglo mal formado hace fallar el lote entero
+    const json error = json::parse(solve_batch("[{\"contexto\": "));
+    VERIFICAR(error.is_object() && error.value("status", "") == "error");
+
+    // En NDJSON solo falla la línea mal formada
+    const std::string valida = curso(3, 4.0, "MC").dump();
+    const json lote = json::parse(solve_batch((valida + "\n{\"contexto\": \n" + valida).c_str()));
+    VERIFICAR(lote.size() == 3);
+    VERIFICAR(lote[1].value("status", "") == "error");
+    VERIFICAR(lote[0] == lote[2]);
+    VERIFICAR(lote[0] == json::parse(solve_process(valida.c_str())));
+}
+
+// ============================================================================
+// REENTRADA
+// ----------------------------------------------------------------------------
+// Muchos hilos llamando a la vez a las funciones reentrantes (y a las de
+// buffer por hilo) deben obtener lo mismo que una llamada serial. La cache
+// compartida queda activa para que los fallos y guardados se crucen.
+// ============================================================================
+
+CASO(llamadas_concurrentes_iguales_a_seriales) {
+    std::vector<std::string> entradas;
+    for (const auto& entrada : entradas_del_lote()) {
+        if (json::parse(entrada)["P"].value("muestreo", "") != "MCMC") entradas.push_back(entrada);
+    }
+
+    solver_configurar_hilos(1);
+    solver_limpiar_cache();
+    std::vector<std::string> esperado;
+    for (const auto& entrada : entradas) esperado.push_back(solve_process(entrada.c_str()));
+    solver_limpiar_cache();
+
+    constexpr int HILOS = 8;
+    constexpr int VUELTAS = 3;
+    std::vector<int> fallas(HILOS, 0);
+    std::vector<std::thread> hilos;
+    for (int h = 0; h < HILOS; ++h) {
+        hilos.emplace_back([&, h] {
+            void* solver = solver_crear(h % 2 == 0 ? 1 : 2);
+            std::vector<char> buffer(1 << 16);
+            for (int vuelta = 0; vuelta < VUELTAS; ++vuelta) {
+                for (size_t k = 0; k < entradas.size(); ++k) {
+                    // Cada hilo recorre las entradas desde otro punto
+                    const size_t i = (k + static_cast<size_t>(h) * 3) % entradas.size();
+                    const char* entrada = entradas[i].c_str();
+
+                    std::string obtenido;
+                    switch ((h + vuelta + k) % 4) {
+                        case 0: obtenido = solve_process(entrada); break;
+                        case 1: {
+                            void* resultado = solve_process_r(entrada);
+                            obtenido = resultado_datos(resultado);
+                            resultado_liberar(resultado);
+                            break;
+                        }
+                        case 2: {
+                            size_t largo = 0;
+                            if (solve_process_en(entrada, buffer.data(), buffer.size(), &largo) == 1) {
+                                obtenido.assign(buffer.data(), largo);
+                            }
+                            break;
+                        }
+                        default: obtenido = solver_resolver(solver, entrada); break;
+                    }
+                    if (obtenido != esperado[i]) ++fallas[h];
+                }
+            }
+            solver_destruir(solver);
+        });
+    }
+    for (auto& hilo : hilos) hilo.join();
+
+    for (int h = 0; h < HILOS; ++h) VERIFICAR(fallas[h] == 0);
+}
+
+// ============================================================================
+// SESIÓN
+// ----------------------------------------------------------------------------
+// sesion_es_posible y sesion_rango responden desde los agregados; deben
+// coincidir con el espacio que recalcula sesion_resultado.
+// ============================================================================
+
+CASO(sesion_consultas_baratas_iguales_al_resultado) {
+    void* sesion = sesion_crear(curso(1, 2.0, "MC").dump().c_str());
+    VERIFICAR(sesion != nullptr);
+
+    for (double nota_c2 : { 1.0, 3.5, 6.0, 7.0 }) {
+        VERIFICAR(sesion_set_grade(sesion, "C2", nota_c2) == 1);
+        const json espacio = json::parse(sesion_resultado(sesion))["maquina_s"];
+        VERIFICAR((sesion_es_posible(sesion) == 1) == espacio["es_posible"].get<bool>());
+
+        // Si no se puede aprobar el espacio no trae rangos
+        const double* rango = sesion_rango(sesion, "Examen");
+        VERIFICAR(rango != nullptr);
+        if (!espacio["es_posible"].get<bool>()) continue;
+        const json& esperado = espacio["rangos_por_evaluacion"]["Examen"];
+        VERIFICAR_CERCA(rango[0], esperado["min_supervivencia"].get<double>(), 1e-9);
+        VERIFICAR_CERCA(rango[1], esperado["min_seguridad"].get<double>(), 1e-9);
+        VERIFICAR_CERCA(rango[2], esperado["max_posible"].get<double>(), 1e-9);
+    }
+
+    // Sin nota C2 vuelve a tener rango; con nota o inexistente no
+    VERIFICAR(sesion_rango(sesion, "C2") == nullptr);
+    VERIFICAR(sesion_clear_grade(sesion, "C2") == 1);
+    VERIFICAR(sesion_rango(sesion, "C2") != nullptr);
+    VERIFICAR(sesion_rango(sesion, "Inexistente") == nullptr);
+
+    sesion_destruir(sesion);
+    VERIFICAR(sesion_es_posible(nullptr) == -1);
+    VERIFICAR(sesion_rango(nullptr, "Examen") == nullptr);
+}
+
+int main() { return correr_pruebas(); }
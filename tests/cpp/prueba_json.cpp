@@ -0,0 +1,75 @@
+#include "prueba.hpp"
+#include "json_serializer.hpp"
+#include <limits>
+#include <stdexcept>
+
+using namespace GradeSolver;
+using json = nlohmann::json;
+
+namespace {
+
+json entrada_con_p(json p) {
+    return json{
+        { "contexto", { { "nota_minima", 1.0 }, { "nota_maxima", 7.0 }, { "nota_aprobacion", 4.0 } } },
+        { "evaluaciones", json::array({ { { "id", "E1" }, { "peso", 1.0 }, { "valor_actual", nullptr }, { "tags", json::array() } } }) },
+        { "restricciones", json::array() },
+        { "P", std::move(p) },
+    };
+}
+
+} // namespace
+
+CASO(perfil_valido) {
+    const auto entrada = JSON::parse_entrada_completa(
+        entrada_con_p({ { "media_historica", 4.5 }, { "desviacion_estandar", 0.8 } }));
+    VERIFICAR(entrada.perfil.has_value());
+    VERIFICAR(entrada.perfil->desviacion_estandar == 0.8);
+}
+
+CASO(perfil_acepta_desviacion_cero) {
+    // Perfil degenerado: con muestreo por importancia la Máquina P cae a Monte Carlo
+    const auto entrada = JSON::parse_entrada_completa(
+        entrada_con_p({ { "media_historica", 4.5 }, { "desviacion_estandar", 0.0 }, { "muestreo", "IS" } }));
+    VERIFICAR(entrada.perfil.has_value());
+    VERIFICAR(entrada.perfil->desviacion_estandar == 0.0);
+}
+
+CASO(perfil_rechaza_desviacion_negativa_o_no_finita) {
+    for (double desviacion : { -1.0, std::numeric_limits<double>::infinity(),
+                               std::numeric_limits<double>::quiet_NaN() }) {
+        VERIFICAR_LANZA(JSON::parse_entrada_completa(
+            entrada_con_p({ { "media_historica", 4.5 }, { "desviacion_estandar", desviacion } })), std::runtime_error);
+        VERIFICAR_LANZA(JSON::parse_perfil_estadistico(
+            json{ { "media_historica", 4.5 }, { "desviacion_estandar", desviacion } }), std::runtime_error);
+    }
+}
+
+CASO(semilla_valida) {
+    VERIFICAR(JSON::parse_entrada_completa(entrada_con_p({ { "semilla", 0 } })).semilla == 0u);
+    VERIFICAR(JSON::parse_entrada_completa(entrada_con_p({ { "semilla", 42 } })).semilla == 42u);
+    VERIFICAR(JSON::parse_entrada_completa(json::parse(R"({"contexto": {"nota_minima": 1, "nota_maxima": 7,
+        "nota_aprobacion": 4}, "evaluaciones": [], "P": {"semilla": 18446744073709551615}})")).semilla ==
+              UINT64_MAX);
+}
+
+CASO(semilla_rechaza_negativas_y_no_enteras) {
+    VERIFICAR_LANZA(JSON::parse_entrada_completa(entrada_con_p({ { "semilla", -1 } })), std::runtime_error);
+    VERIFICAR_LANZA(JSON::parse_entrada_completa(entrada_con_p({ { "semilla", 1.5 } })), std::runtime_error);
+    VERIFICAR_LANZA(JSON::parse_entrada_completa(entrada_con_p({ { "semilla", "7" } })), std::runtime_error);
+    VERIFICAR_LANZA(JSON::parse_entrada_completa(entrada_con_p({ { "semilla", nullptr } })), std::runtime_error);
+}
+
+CASO(nombres_de_estrategias_del_registro) {
+    const auto estrategias = estrategias_registradas();
+    VERIFICAR(estrategias.size() == 4);
+    for (auto estrategia : estrategias) {
+        const std::string nombre = JSON::tipo_estrategia_to_string(estrategia);
+        VERIFICAR(JSON::string_to_tipo_estrategia(nombre) == estrategia);
+        VERIFICAR(nombre == nombre_estrategia(estrategia));
+    }
+    VERIFICAR(JSON::tipo_estrategia_to_string(TipoEstrategia::MAX_WEIGHT_FIRST) == "MAX_WEIGHT_FIRST");
+    VERIFICAR_LANZA(JSON::string_to_tipo_estrategia("FRONTERA"), std::runtime_error);
+    VERIFICAR(!estrategia_por_nombre("minimum").has_value());
+}
+
+int main() { return correr_pruebas(); }
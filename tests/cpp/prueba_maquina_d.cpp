@@ -0,0 +1,198 @@
+#include "prueba.hpp"
+#include "interface_d.hpp"
+#include <random>
+
+// ============================================================================
+// PLANES DE LA MÁQUINA D
+// ----------------------------------------------------------------------------
+// Todo plan de un curso posible debe cumplir las restricciones y ser
+// minimal: ninguna pendiente puede bajar sin romper alguna restricción,
+// salvo que ya esté en su piso (nota_minima en BALANCED, el mínimo de
+// supervivencia en el resto).
+// ============================================================================
+
+namespace {
+
+const Contexto ESCALA_7{ 1.0, 7.0, 4.0 };
+const Contexto ESCALA_100{ 0.0, 100.0, 55.0 };
+
+std::vector<double> escenario_del_plan(const CursoCompilado& curso, const Sugerencias& plan) {
+    std::vector<double> escenario(curso.size());
+    curso.llenar_escenario(escenario, 0.0);
+    for (int idx : curso.pendientes) escenario[idx] = plan.notas_objetivo.at(curso.ids[idx]);
+    return escenario;
+}
+
+void verificar_plan_minimal(const CursoCompilado& curso, const EspacioSoluciones& espacio, const Sugerencias& plan) {
+    std::vector<double> escenario = escenario_del_plan(curso, plan);
+    VERIFICAR(validar_escenario(curso, escenario));
+
+    const double delta = 1e-7 * (curso.ctx.nota_maxima - curso.ctx.nota_minima);
+    for (int idx : curso.pendientes) {
+        const double piso = plan.estrategia_aplicada == TipoEstrategia::BALANCED
+            ? curso.ctx.nota_minima
+            : espacio.rangos_por_evaluacion.at(curso.ids[idx]).min_supervivencia;
+        if (escenario[idx] - delta < piso) continue;
+
+        const double nota = escenario[idx];
+        escenario[idx] = nota - delta;
+        const bool sigue_valido = validar_escenario(curso, escenario);
+        escenario[idx] = nota;
+        if (sigue_valido) {
+            std::fprintf(stderr, "  %s puede bajar desde %.17g (estrategia %d)\n", curso.ids[idx].c_str(), nota,
+                         static_cast<int>(plan.estrategia_aplicada.value()));
+        }
+        VERIFICAR(!sigue_valido);
+    }
+}
+
+void verificar_curso(const Contexto& ctx, const std::vector<Evaluacion>& evaluaciones,
+                     const std::vector<Restriccion>& restricciones) {
+    const CursoCompilado curso = compilar_curso(ctx, evaluaciones, restricciones);
+    const EspacioSoluciones espacio = MaquinaS(ctx).calcular_espacio(curso);
+    if (!espacio.es_posible) return;
+
+    for (const auto& plan : MaquinaD(ctx).generar_planes(espacio, curso)) {
+        verificar_plan_minimal(curso, espacio, plan);
+    }
+}
+
+} // namespace
+
+CASO(tags_superpuestos) {
+    // Y está en los dos tags. Resolver "a" y después "b" por separado deja X
+    // más alta de lo necesario: la subida de Y para "b" da holgura en "a".
+    std::vector<Evaluacion> evaluaciones = {
+        { "X", 0.1, std::nullopt, { "a" } },
+        { "Y", 0.1, std::nullopt, { "a", "b" } },
+        { "Z", 0.1, std::nullopt, { "b" } },
+        { "W", 0.7, 7.0, {} },
+    };
+    std::vector<Restriccion> restricciones = {
+        { "Promedio a", TipoRestriccion::PROMEDIO_SIMPLE_TAG, "a", 5.0 },
+        { "Promedio b", TipoRestriccion::PROMEDIO_SIMPLE_TAG, "b", 6.0 },
+    };
+    verificar_curso(ESCALA_7, evaluaciones, restricciones);
+
+    const CursoCompilado curso = compilar_curso(ESCALA_7, evaluaciones, restricciones);
+    const EspacioSoluciones espacio = MaquinaS(ESCALA_7).calcular_espacio(curso);
+    const Sugerencias plan = MaquinaD(ESCALA_7).generar_plan(espacio, curso, TipoEstrategia::BALANCED);
+
+    // BALANCED nivela "a" con X = Y = 5 y luego "b" con Y = Z = 6; con Y en
+    // 6 el promedio de "a" se cumple con X en 4
+    VERIFICAR_CERCA(plan.notas_objetivo.at("X"), 4.0, 1e-12);
+    VERIFICAR_CERCA(plan.notas_objetivo.at("Y"), 6.0, 1e-12);
+    VERIFICAR_CERCA(plan.notas_objetivo.at("Z"), 6.0, 1e-12);
+}
+
+CASO(tags_superpuestos_con_nota_minima) {
+    std::vector<Evaluacion> evaluaciones = {
+        { "Control 1", 0.15, std::nullopt, { "control", "teoria" } },
+        { "Control 2", 0.15, std::nullopt, { "control" } },
+        { "Certamen", 0.4, std::nullopt, { "teoria" } },
+        { "Lab", 0.3, 62.0, { "lab", "control" } },
+    };
+    std::vector<Restriccion> restricciones = {
+        { "Promedio controles", TipoRestriccion::PROMEDIO_SIMPLE_TAG, "control", 60.0 },
+        { "Promedio teoria", TipoRestriccion::PROMEDIO_SIMPLE_TAG, "teoria", 50.0 },
+        { "Minimo teoria", TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG, "teoria", 35.0 },
+    };
+    verificar_curso(ESCALA_100, evaluaciones, restricciones);
+}
+
+CASO(promedio_justo_en_aprobacion) {
+    // 0.5 * 4.0 + 0.5 * 4.0 = 4.0: el plan no debe empujar la nota sobre el umbral
+    std::vector<Evaluacion> evaluaciones = {
+        { "E1", 0.5, 4.0, {} },
+        { "E2", 0.5, std::nullopt, {} },
+    };
+    const CursoCompilado curso = compilar_curso(ESCALA_7, evaluaciones, {});
+    const EspacioSoluciones espacio = MaquinaS(ESCALA_7).calcular_espacio(curso);
+    for (const auto& plan : MaquinaD(ESCALA_7).generar_planes(espacio, curso)) {
+        VERIFICAR(plan.notas_objetivo.at("E2") == 4.0);
+        VERIFICAR(plan.promedio_final_teorico == ESCALA_7.nota_aprobacion);
+    }
+    verificar_curso(ESCALA_7, evaluaciones, {});
+
+    // Lo conocido deja el promedio exacto con la pendiente en el piso
+    evaluaciones[0].valor_actual = 7.0;
+    const CursoCompilado piso = compilar_curso(ESCALA_7, evaluaciones, {});
+    const EspacioSoluciones espacio_piso = MaquinaS(ESCALA_7).calcular_espacio(piso);
+    for (const auto& plan : MaquinaD(ESCALA_7).generar_planes(espacio_piso, piso)) {
+        VERIFICAR(plan.notas_objetivo.at("E2") == 1.0);
+        VERIFICAR(plan.promedio_final_teorico == ESCALA_7.nota_aprobacion);
+    }
+}
+
+CASO(promedio_justo_en_aprobacion_con_redondeo) {
+    // 0.1 + 0.2 != 0.3 en double: el despeje queda a un ulp del umbral y
+    // el plan debe terminar cumpliéndolo
+    std::vector<Evaluacion> evaluaciones = {
+        { "E1", 0.1, std::nullopt, {} },
+        { "E2", 0.2, std::nullopt, {} },
+        { "E3", 0.7, 55.0, {} },
+    };
+    verificar_curso(ESCALA_100, evaluaciones, {});
+}
+
+CASO(frontera_sin_estrategia_y_con_nivel) {
+    std::vector<Evaluacion> evaluaciones = {
+        { "E1", 0.3, 3.0, {} },
+        { "E2", 0.3, std::nullopt, {} },
+        { "E3", 0.4, std::nullopt, {} },
+    };
+    const CursoCompilado curso = compilar_curso(ESCALA_7, evaluaciones, {});
+    const EspacioSoluciones espacio = MaquinaS(ESCALA_7).calcular_espacio(curso);
+    MaquinaD maquina(ESCALA_7);
+    const Sugerencias minimo = maquina.generar_plan(espacio, curso, TipoEstrategia::MINIMUM);
+
+    const auto frontera = maquina.generar_frontera(espacio, curso, 5);
+    VERIFICAR(frontera.size() == 5);
+    for (size_t k = 0; k < frontera.size(); ++k) {
+        VERIFICAR(frontera[k].nivel == k / 4.0);
+        VERIFICAR(!frontera[k].plan.estrategia_aplicada.has_value());
+    }
+    VERIFICAR(frontera.front().plan.notas_objetivo == minimo.notas_objetivo);
+    for (const auto& [id, nota] : frontera.back().plan.notas_objetivo) VERIFICAR(nota == ESCALA_7.nota_maxima);
+
+    const auto un_punto = maquina.generar_frontera(espacio, curso, 1);
+    VERIFICAR(un_punto.size() == 1 && un_punto[0].nivel == 0.0);
+    VERIFICAR(maquina.generar_frontera(espacio, curso, 0).empty());
+}
+
+CASO(cursos_aleatorios_con_tags_superpuestos) {
+    std::mt19937 gen(7331);
+    const std::vector<std::string> tags = { "a", "b", "c" };
+
+    for (int curso = 0; curso < 300; ++curso) {
+        const Contexto& ctx = curso % 2 == 0 ? ESCALA_7 : ESCALA_100;
+        const double escala = ctx.nota_maxima - ctx.nota_minima;
+        std::uniform_real_distribution<double> unidad(0.0, 1.0);
+
+        int n = 2 + static_cast<int>(gen() % 7);
+        std::vector<Evaluacion> evaluaciones;
+        double suma_pesos = 0.0;
+        for (int i = 0; i < n; ++i) {
+            Evaluacion ev{ "E" + std::to_string(i), 0.05 + unidad(gen), std::nullopt, {} };
+            suma_pesos += ev.peso;
+            if (unidad(gen) < 0.3) ev.valor_actual = ctx.nota_minima + escala * (0.3 + 0.7 * unidad(gen));
+            for (const auto& tag : tags) {
+                if (unidad(gen) < 0.5) ev.tags.push_back(tag);
+            }
+            evaluaciones.push_back(ev);
+        }
+        for (auto& ev : evaluaciones) ev.peso /= suma_pesos;
+
+        std::vector<Restriccion> restricciones;
+        for (size_t t = 0; t < tags.size(); ++t) {
+            const double valor = ctx.nota_minima + escala * (0.2 + 0.6 * unidad(gen));
+            TipoRestriccion tipo = unidad(gen) < 0.75 ? TipoRestriccion::PROMEDIO_SIMPLE_TAG
+                                                      : TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG;
+            restricciones.push_back({ "R" + std::to_string(t), tipo, tags[t], valor });
+        }
+
+        verificar_curso(ctx, evaluaciones, restricciones);
+    }
+}
+
+int main() { return correr_pruebas(); }
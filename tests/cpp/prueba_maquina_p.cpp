@@ -0,0 +1,356 @@
+#include "prueba.hpp"
+#include "interface_p.hpp"
+#include "kernel_bloques.hpp"
+
+namespace {
+
+const Contexto ESCALA_7{ 1.0, 7.0, 4.0 };
+
+struct CursoPrueba {
+    CursoCompilado curso;
+    EspacioSoluciones espacio;
+    std::vector<Sugerencias> planes;
+};
+
+CursoPrueba preparar(const std::vector<Evaluacion>& evaluaciones, const std::vector<Restriccion>& restricciones) {
+    CursoPrueba c;
+    c.curso = compilar_curso(ESCALA_7, evaluaciones, restricciones);
+    c.espacio = MaquinaS(ESCALA_7).calcular_espacio(c.curso);
+    c.planes = MaquinaD(ESCALA_7).generar_planes(c.espacio, c.curso);
+    return c;
+}
+
+CursoPrueba curso_basico() {
+    return preparar({
+        { "C1", 0.3, 3.5, { "certamen" } },
+        { "C2", 0.3, std::nullopt, { "certamen" } },
+        { "Lab", 0.2, std::nullopt, { "lab" } },
+        { "Examen", 0.2, std::nullopt, {} },
+    }, {
+        { "Promedio certamenes", TipoRestriccion::PROMEDIO_SIMPLE_TAG, "certamen", 3.8 },
+        { "Minimo lab", TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG, "lab", 3.0 },
+    });
+}
+
+} // namespace
+
+CASO(importancia_sin_dispersion_cae_a_monte_carlo) {
+    // Con desviación 0 la propuesta de importancia no está definida (se
+    // escala por 1/σ²): se simula con Monte Carlo y así se reporta
+    const CursoPrueba c = curso_basico();
+    const PerfilEstadistico perfil{ 4.5, 0.0 };
+    MaquinaP maquina(ESCALA_7, 42);
+
+    const auto importancia = maquina.analizar_planes(c.espacio, c.planes, c.curso, perfil, 4096,
+                                                     std::nullopt, Muestreo::IMPORTANCIA);
+    const auto monte_carlo = maquina.analizar_planes(c.espacio, c.planes, c.curso, perfil, 4096,
+                                                     std::nullopt, Muestreo::MONTE_CARLO);
+
+    VERIFICAR(importancia.size() == monte_carlo.size());
+    for (size_t p = 0; p < importancia.size(); ++p) {
+        VERIFICAR(importancia[p].muestreo == Muestreo::MONTE_CARLO);
+        VERIFICAR(std::isfinite(importancia[p].probabilidad_general));
+        VERIFICAR(importancia[p].probabilidad_general == monte_carlo[p].probabilidad_general);
+        VERIFICAR(importancia[p].probabilidad_del_plan == monte_carlo[p].probabilidad_del_plan);
+    }
+}
+
+CASO(qmc_igual_con_cualquier_cantidad_de_hilos) {
+    // Réplicas y bloques se reparten juntos; con semilla el resultado no
+    // depende del reparto, tampoco con tramos que cortan las réplicas
+    const CursoPrueba c = curso_basico();
+    const PerfilEstadistico perfil{ 4.5, 1.0 };
+    const auto serial = MaquinaP(ESCALA_7, 7, 1).analizar_planes(c.espacio, c.planes, c.curso, perfil, 20000,
+                                                                 std::nullopt, Muestreo::QMC);
+
+    for (int hilos : { 2, 3, 8 }) {
+        const auto paralelo = MaquinaP(ESCALA_7, 7, hilos).analizar_planes(c.espacio, c.planes, c.curso, perfil,
+                                                                           20000, std::nullopt, Muestreo::QMC);
+        for (size_t p = 0; p < serial.size(); ++p) {
+            VERIFICAR(paralelo[p].muestreo == Muestreo::QMC);
+            VERIFICAR(paralelo[p].probabilidad_general == serial[p].probabilidad_general);
+            VERIFICAR(paralelo[p].probabilidad_del_plan == serial[p].probabilidad_del_plan);
+            VERIFICAR(paralelo[p].intervalo_plan.inferior == serial[p].intervalo_plan.inferior);
+            VERIFICAR(paralelo[p].sensibilidades == serial[p].sensibilidades);
+        }
+    }
+
+    MaquinaP por_tramos(ESCALA_7, 7, 4);
+    auto analisis = por_tramos.analizar_por_tramos(c.espacio, c.planes, c.curso, perfil, 20000, std::nullopt,
+                                                   Muestreo::QMC, 1000);
+    while (analisis.avanzar()) {}
+    const auto reportes = analisis.tomar_reportes();
+    for (size_t p = 0; p < serial.size(); ++p) {
+        VERIFICAR(reportes[p].probabilidad_del_plan == serial[p].probabilidad_del_plan);
+        VERIFICAR(reportes[p].sensibilidades == serial[p].sensibilidades);
+    }
+}
+
+CASO(qmc_con_menos_simulaciones_que_replicas_cae_a_monte_carlo) {
+    // Con menos de un punto por réplica QMC simularía más de lo pedido
+    const CursoPrueba c = curso_basico();
+    const PerfilEstadistico perfil{ 4.5, 1.0 };
+    MaquinaP maquina(ESCALA_7, 42);
+
+    for (int simulaciones : { 0, 1, 15 }) {
+        const auto qmc = maquina.analizar_planes(c.espacio, c.planes, c.curso, perfil, simulaciones,
+                                                 std::nullopt, Muestreo::QMC);
+        const auto monte_carlo = maquina.analizar_planes(c.espacio, c.planes, c.curso, perfil, simulaciones,
+                                                         std::nullopt, Muestreo::MONTE_CARLO);
+        for (size_t p = 0; p < qmc.size(); ++p) {
+            VERIFICAR(qmc[p].muestreo == Muestreo::MONTE_CARLO);
+            VERIFICAR(qmc[p].simulaciones_usadas <= simulaciones);
+            VERIFICAR(qmc[p].simulaciones_usadas == monte_carlo[p].simulaciones_usadas);
+        }
+    }
+
+    const auto justo = maquina.analizar_planes(c.espacio, c.planes, c.curso, perfil, 16, std::nullopt, Muestreo::QMC);
+    VERIFICAR(justo[0].muestreo == Muestreo::QMC);
+    VERIFICAR(justo[0].simulaciones_usadas == 16);
+}
+
+CASO(sensibilidades_coinciden_con_diferencias_finitas) {
+    // Subir la media del perfil sube la de todas las pendientes a la vez, así
+    // que la derivada de P(aprobar) respecto de la media es la suma de las
+    // sensibilidades. Con semilla fija las tres corridas usan los mismos
+    // números aleatorios y la diferencia centrada tiene poco ruido.
+    const CursoPrueba c = curso_basico();
+    const double h = 0.05;
+    const int simulaciones = 200000;
+
+    for (Muestreo muestreo : { Muestreo::MONTE_CARLO, Muestreo::QMC }) {
+        MaquinaP maquina(ESCALA_7, 11);
+        auto probabilidad = [&](double media) {
+            const PerfilEstadistico perfil{ media, 1.0 };
+            return maquina.analizar_planes(c.espacio, c.planes, c.curso, perfil, simulaciones, std::nullopt,
+                                           muestreo)[0];
+        };
+
+        const ReporteProbabilidad base = probabilidad(4.5);
+        VERIFICAR(base.sensibilidades.size() == c.curso.pendientes.size());
+        double suma = 0.0;
+        for (const auto& [id, sensibilidad] : base.sensibilidades) {
+            VERIFICAR(sensibilidad > 0.0);  // Subir la media de una pendiente nunca baja P(aprobar)
+            suma += sensibilidad;
+        }
+
+        const double diferencia = (probabilidad(4.5 + h).probabilidad_general -
+                                   probabilidad(4.5 - h).probabilidad_general) / (2.0 * h);
+        VERIFICAR_CERCA(suma, diferencia, 0.03 * std::abs(diferencia));
+    }
+}
+
+// ============================================================================
+// MODO DE PRECISIÓN
+// ----------------------------------------------------------------------------
+// Se simula de a bloques (el primero de MaquinaP::TAM_BLOQUE_PRECISION
+// escenarios) hasta que los tres intervalos de Wilson de todos los planes
+// tengan semiancho <= el objetivo, o hasta el tope de simulaciones.
+// ============================================================================
+
+namespace {
+
+constexpr int TAM_BLOQUE_PRECISION = 4096;
+
+double peor_semiancho(const ReporteProbabilidad& reporte) {
+    return std::max({ reporte.intervalo_general.semiancho(), reporte.intervalo_plan.semiancho(),
+                      reporte.intervalo_viabilidad.semiancho() });
+}
+
+} // namespace
+
+CASO(precision_alcanzada_se_detiene_antes_del_tope) {
+    const CursoPrueba c = curso_basico();
+    const PerfilEstadistico perfil{ 4.5, 1.0 };
+    const int tope = 1000000;
+    const PrecisionObjetivo precision{ 0.01 };
+
+    const auto reportes = MaquinaP(ESCALA_7, 5).analizar_planes(c.espacio, c.planes, c.curso, perfil, tope,
+                                                                 precision);
+    VERIFICAR(!reportes.empty());
+    const int usadas = reportes[0].simulaciones_usadas;
+    VERIFICAR(usadas >= TAM_BLOQUE_PRECISION);
+    VERIFICAR(usadas < tope);
+    for (const auto& reporte : reportes) {
+        VERIFICAR(reporte.simulaciones_usadas == usadas);  // Una sola pasada para todos los planes
+        VERIFICAR(reporte.confianza == precision.confianza);
+        VERIFICAR(peor_semiancho(reporte) <= precision.semiancho);
+    }
+
+    // El primer bloque solo no alcanza: el objetivo se pidió con sentido
+    const auto primer_bloque = MaquinaP(ESCALA_7, 5).analizar_planes(c.espacio, c.planes, c.curso, perfil,
+                                                                      TAM_BLOQUE_PRECISION);
+    double peor = 0.0;
+    for (const auto& reporte : primer_bloque) peor = std::max(peor, peor_semiancho(reporte));
+    VERIFICAR(peor > precision.semiancho);
+}
+
+CASO(precision_inalcanzable_usa_exactamente_el_tope) {
+    const CursoPrueba c = curso_basico();
+    const PerfilEstadistico perfil{ 4.5, 1.0 };
+
+    // Un tope que no es múltiplo del bloque ni de ANCHO_BLOQUE
+    for (int tope : { 1000, 20000, 50001 }) {
+        const auto reportes = MaquinaP(ESCALA_7, 5).analizar_planes(c.espacio, c.planes, c.curso, perfil, tope,
+                                                                     PrecisionObjetivo{ 1e-6 });
+        for (const auto& reporte : reportes) {
+            VERIFICAR(reporte.simulaciones_usadas == tope);
+            VERIFICAR(peor_semiancho(reporte) > 1e-6);
+        }
+    }
+}
+
+CASO(precision_igual_con_cualquier_cantidad_de_hilos) {
+    // El calendario de bloques depende solo de los conteos
+    const CursoPrueba c = curso_basico();
+    const PerfilEstadistico perfil{ 4.5, 1.0 };
+    const PrecisionObjetivo precision{ 0.005 };
+    const auto serial = MaquinaP(ESCALA_7, 9, 1).analizar_planes(c.espacio, c.planes, c.curso, perfil, 500000,
+                                                                 precision);
+    VERIFICAR(serial[0].simulaciones_usadas > TAM_BLOQUE_PRECISION);  // Más de un bloque
+
+    for (int hilos : { 2, 3, 8 }) {
+        const auto paralelo = MaquinaP(ESCALA_7, 9, hilos).analizar_planes(c.espacio, c.planes, c.curso, perfil,
+                                                                           500000, precision);
+        VERIFICAR(paralelo.size() == serial.size());
+        for (size_t p = 0; p < serial.size(); ++p) {
+            VERIFICAR(paralelo[p].simulaciones_usadas == serial[p].simulaciones_usadas);
+            VERIFICAR(paralelo[p].probabilidad_general == serial[p].probabilidad_general);
+            VERIFICAR(paralelo[p].probabilidad_del_plan == serial[p].probabilidad_del_plan);
+            VERIFICAR(paralelo[p].intervalo_viabilidad.superior == serial[p].intervalo_viabilidad.superior);
+            VERIFICAR(paralelo[p].sensibilidades == serial[p].sensibilidades);
+        }
+    }
+}
+
+// ============================================================================
+// NÚCLEO POR BLOQUES
+// ----------------------------------------------------------------------------
+// El núcleo simula por columnas y valida bloques enteros; cada escenario debe
+// dar lo mismo que sortearlo y validarlo solo, con validar_escenario. Los
+// conteos se comparan exactos, con un último bloque incompleto.
+// ============================================================================
+
+namespace {
+
+constexpr uint64_t ESCENARIOS_NUCLEO = 1000;  // 15 bloques y uno de 40
+
+// Objetivos de dos planes (NaN donde el plan no fija la evaluación)
+std::vector<double> objetivos_nucleo(const CursoCompilado& curso) {
+    const double libre = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> objetivo(2 * curso.size(), libre);
+    objetivo[1] = 4.0;                    // Plan 0: C2 >= 4
+    objetivo[curso.size() + 1] = 3.5;     // Plan 1: C2 >= 3.5, Lab >= 4.5, Examen >= 3
+    objetivo[curso.size() + 2] = 4.5;
+    objetivo[curso.size() + 3] = 3.0;
+    return objetivo;
+}
+
+// Escenario i sorteado como en el núcleo, pero uno a la vez
+std::vector<double> escenario_escalar(const DatosBloque& datos, uint64_t i, const double* medias) {
+    const CursoCompilado& curso = *datos.curso;
+    std::vector<double> escenario(curso.size());
+    curso.llenar_escenario(escenario, 0.0);
+    const uint64_t flujo = datos.generador->flujo(i);
+    for (int idx : curso.pendientes) {
+        const double media = medias ? medias[idx] : datos.media;
+        const double z = GeneradorContador::normal(flujo, static_cast<uint64_t>(idx));
+        escenario[idx] = std::clamp(media + datos.desviacion * z, datos.nota_minima, datos.nota_maxima);
+    }
+    return escenario;
+}
+
+bool cumple_plan(const DatosBloque& datos, size_t p, const std::vector<double>& escenario) {
+    for (int idx : datos.curso->pendientes) {
+        const double objetivo = datos.objetivo[p * datos.curso->size() + idx];
+        if (!std::isnan(objetivo) && escenario[idx] < objetivo) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+CASO(nucleo_por_bloques_igual_al_escalar) {
+    const CursoPrueba c = curso_basico();
+    const GeneradorContador generador(2024);
+    const std::vector<double> objetivo = objetivos_nucleo(c.curso);
+    const DatosBloque datos{ &c.curso, &generador, 4.5, 1.2, 1.0, 7.0, objetivo.data(), 2 };
+
+    int aprueba = 0;
+    int plan_y_aprueba[2] = { 0, 0 };
+    EvaluadorEscenarios evaluador(c.curso);
+    std::vector<double> notas(c.curso.size() * ANCHO_BLOQUE);
+    preparar_bloque(c.curso, notas.data());
+    for (uint64_t i = 0; i < ESCENARIOS_NUCLEO; i += ANCHO_BLOQUE) {
+        const size_t ancho = std::min<uint64_t>(ANCHO_BLOQUE, ESCENARIOS_NUCLEO - i);
+        simular_bloque(datos, evaluador, i, ancho, notas.data(), aprueba, plan_y_aprueba);
+    }
+
+    int aprueba_escalar = 0;
+    int plan_y_aprueba_escalar[2] = { 0, 0 };
+    for (uint64_t i = 0; i < ESCENARIOS_NUCLEO; ++i) {
+        const std::vector<double> escenario = escenario_escalar(datos, i, nullptr);
+        if (!validar_escenario(c.curso, escenario)) continue;
+        ++aprueba_escalar;
+        for (size_t p = 0; p < 2; ++p) plan_y_aprueba_escalar[p] += cumple_plan(datos, p, escenario);
+    }
+
+    VERIFICAR(aprueba > 0 && aprueba < static_cast<int>(ESCENARIOS_NUCLEO));
+    VERIFICAR(aprueba == aprueba_escalar);
+    VERIFICAR(plan_y_aprueba[0] == plan_y_aprueba_escalar[0]);
+    VERIFICAR(plan_y_aprueba[1] == plan_y_aprueba_escalar[1]);
+}
+
+CASO(nucleo_de_importancia_igual_al_escalar) {
+    // Mismas sumas de pesos que reponderar cada escenario por separado; la
+    // razón de verosimilitud se acumula en el mismo orden de pendientes
+    const CursoPrueba c = curso_basico();
+    const GeneradorContador generador(77);
+    const std::vector<double> objetivo = objetivos_nucleo(c.curso);
+    const DatosBloque datos{ &c.curso, &generador, 3.5, 1.0, 1.0, 7.0, objetivo.data(), 2 };
+    const std::vector<double> medias = { 0.0, 4.6, 4.2, 5.0 };
+
+    std::vector<double> sumas(2 + 2 * datos.planes, 0.0);
+    EvaluadorEscenarios evaluador(c.curso);
+    std::vector<double> notas(c.curso.size() * ANCHO_BLOQUE);
+    preparar_bloque(c.curso, notas.data());
+    for (uint64_t i = 0; i < ESCENARIOS_NUCLEO; i += ANCHO_BLOQUE) {
+        const size_t ancho = std::min<uint64_t>(ANCHO_BLOQUE, ESCENARIOS_NUCLEO - i);
+        simular_bloque_importancia(datos, evaluador, medias.data(), i, ancho, notas.data(), sumas.data());
+    }
+
+    std::vector<double> sumas_escalar(sumas.size(), 0.0);
+    for (uint64_t i = 0; i < ESCENARIOS_NUCLEO; i += ANCHO_BLOQUE) {
+        // Las sumas del núcleo van por bloque; aquí también
+        std::vector<double> bloque(sumas.size(), 0.0);
+        for (uint64_t j = i; j < std::min(i + ANCHO_BLOQUE, ESCENARIOS_NUCLEO); ++j) {
+            const std::vector<double> escenario = escenario_escalar(datos, j, medias.data());
+            if (!validar_escenario(c.curso, escenario)) continue;
+
+            double log_razon = 0.0;
+            const uint64_t flujo = generador.flujo(j);
+            for (int idx : c.curso.pendientes) {
+                const double z = GeneradorContador::normal(flujo, static_cast<uint64_t>(idx));
+                const double x = medias[idx] + datos.desviacion * z;
+                const double d_perfil = x - datos.media;
+                const double d_propuesta = x - medias[idx];
+                log_razon += (d_propuesta * d_propuesta - d_perfil * d_perfil) *
+                             (1.0 / (2.0 * datos.desviacion * datos.desviacion));
+            }
+            const double w = std::exp(log_razon);
+            bloque[0] += w;
+            bloque[1] += w * w;
+            for (size_t p = 0; p < datos.planes; ++p) {
+                if (!cumple_plan(datos, p, escenario)) continue;
+                bloque[2 + 2 * p] += w;
+                bloque[3 + 2 * p] += w * w;
+            }
+        }
+        for (size_t k = 0; k < sumas.size(); ++k) sumas_escalar[k] += bloque[k];
+    }
+
+    VERIFICAR(sumas[0] > 0.0);
+    for (size_t k = 0; k < sumas.size(); ++k) VERIFICAR(sumas[k] == sumas_escalar[k]);
+}
+
+int main() { return correr_pruebas(); }
@@ -0,0 +1,250 @@
+#include "prueba.hpp"
+#include "interface_s.hpp"
+#include <random>
+
+// ============================================================================
+// EXACTO vs BISECCION
+// ----------------------------------------------------------------------------
+// La bisección hace 15 pasos sobre [nota_minima, nota_maxima] y devuelve el
+// extremo superior del intervalo final, que siempre permite aprobar. El
+// límite exacto es el menor valor que aprueba, así que debe quedar a lo más
+// un ancho de intervalo por debajo de la bisección, nunca por encima.
+// ============================================================================
+
+namespace {
+
+const Contexto ESCALA_7{ 1.0, 7.0, 4.0 };
+const Contexto ESCALA_100{ 0.0, 100.0, 55.0 };
+
+double tolerancia_biseccion(const Contexto& ctx) {
+    return (ctx.nota_maxima - ctx.nota_minima) / (1 << 15) * (1.0 + 1e-9);
+}
+
+void comparar_metodos(const Contexto& ctx, const std::vector<Evaluacion>& evaluaciones,
+                      const std::vector<Restriccion>& restricciones) {
+    EspacioSoluciones exacto = MaquinaS(ctx, MetodoLimites::EXACTO).calcular_espacio(evaluaciones, restricciones);
+    EspacioSoluciones biseccion = MaquinaS(ctx, MetodoLimites::BISECCION).calcular_espacio(evaluaciones, restricciones);
+
+    VERIFICAR(exacto.es_posible == biseccion.es_posible);
+    VERIFICAR(exacto.restricciones_incumplibles == biseccion.restricciones_incumplibles);
+    VERIFICAR(exacto.rangos_por_evaluacion.size() == biseccion.rangos_por_evaluacion.size());
+
+    const double tol = tolerancia_biseccion(ctx);
+    const double ulps = 1e-12 * (ctx.nota_maxima - ctx.nota_minima);
+    for (const auto& [id, rango] : exacto.rangos_por_evaluacion) {
+        auto it = biseccion.rangos_por_evaluacion.find(id);
+        VERIFICAR(it != biseccion.rangos_por_evaluacion.end());
+        if (it == biseccion.rangos_por_evaluacion.end()) continue;
+        const RangoFactible& ref = it->second;
+
+        VERIFICAR_CERCA(rango.min_supervivencia, ref.min_supervivencia, tol);
+        VERIFICAR_CERCA(rango.min_seguridad, ref.min_seguridad, tol);
+        VERIFICAR(rango.min_supervivencia <= ref.min_supervivencia + ulps);
+        VERIFICAR(rango.min_seguridad <= ref.min_seguridad + ulps);
+        VERIFICAR(rango.max_posible == ref.max_posible);
+    }
+}
+
+} // namespace
+
+CASO(casos_de_ejemplo) {
+    std::vector<Evaluacion> evaluaciones = {
+        { "Certamen 1", 0.2, std::nullopt, { "certamen" } },
+        { "Certamen 2", 0.3, std::nullopt, { "certamen" } },
+        { "Proyecto", 0.5, std::nullopt, { "proyecto" } },
+    };
+    std::vector<Restriccion> restricciones = {
+        { "Promedio de certamenes", TipoRestriccion::PROMEDIO_SIMPLE_TAG, "certamen", 40.0 },
+        { "Minimo del proyecto", TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG, "proyecto", 30.0 },
+    };
+    comparar_metodos(ESCALA_100, evaluaciones, restricciones);
+
+    evaluaciones[0].valor_actual = 35.0;
+    comparar_metodos(ESCALA_100, evaluaciones, restricciones);
+}
+
+CASO(sin_pendientes) {
+    std::vector<Evaluacion> evaluaciones = {
+        { "C1", 0.5, 5.0, { "c" } },
+        { "C2", 0.5, 4.5, { "c" } },
+    };
+    std::vector<Restriccion> restricciones = {
+        { "Promedio C", TipoRestriccion::PROMEDIO_SIMPLE_TAG, "c", 4.0 },
+    };
+    comparar_metodos(ESCALA_7, evaluaciones, restricciones);
+
+    EspacioSoluciones espacio = MaquinaS(ESCALA_7).calcular_espacio(evaluaciones, restricciones);
+    VERIFICAR(espacio.es_posible);
+    VERIFICAR(espacio.rangos_por_evaluacion.empty());
+}
+
+CASO(curso_imposible) {
+    // Ni con 7.0 en lo pendiente se llega al promedio global, al del tag ni al mínimo
+    std::vector<Evaluacion> evaluaciones = {
+        { "C1", 0.6, 1.0, { "c" } },
+        { "C2", 0.2, 2.0, { "c", "lab" } },
+        { "C3", 0.2, std::nullopt, { "c" } },
+    };
+    std::vector<Restriccion> restricciones = {
+        { "Promedio C", TipoRestriccion::PROMEDIO_SIMPLE_TAG, "c", 4.0 },
+        { "Minimo lab", TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG, "lab", 3.0 },
+    };
+    comparar_metodos(ESCALA_7, evaluaciones, restricciones);
+
+    EspacioSoluciones espacio = MaquinaS(ESCALA_7).calcular_espacio(evaluaciones, restricciones);
+    VERIFICAR(!espacio.es_posible);
+    VERIFICAR((espacio.restricciones_incumplibles ==
+               std::vector<std::string>{ "GLOBAL_PASS_LIMIT", "Promedio C", "Minimo lab" }));
+}
+
+CASO(seguridad_imposible_devuelve_maximo) {
+    // Con el resto en aprobación, ni un 7.0 alcanza: ambos métodos devuelven el techo
+    std::vector<Evaluacion> evaluaciones = {
+        { "E1", 0.5, 2.0, {} },
+        { "E2", 0.25, std::nullopt, {} },
+        { "E3", 0.25, std::nullopt, {} },
+    };
+    comparar_metodos(ESCALA_7, evaluaciones, {});
+
+    EspacioSoluciones espacio = MaquinaS(ESCALA_7).calcular_espacio(evaluaciones, {});
+    VERIFICAR(espacio.es_posible);
+    VERIFICAR(espacio.rangos_por_evaluacion.at("E2").min_seguridad == ESCALA_7.nota_maxima);
+}
+
+CASO(limite_recortado_en_nota_minima) {
+    // Lo conocido ya aprueba: cualquier nota sirve y el límite queda en el piso
+    std::vector<Evaluacion> evaluaciones = {
+        { "E1", 0.8, 7.0, {} },
+        { "E2", 0.2, std::nullopt, {} },
+    };
+    comparar_metodos(ESCALA_7, evaluaciones, {});
+
+    EspacioSoluciones espacio = MaquinaS(ESCALA_7).calcular_espacio(evaluaciones, {});
+    const RangoFactible& rango = espacio.rangos_por_evaluacion.at("E2");
+    VERIFICAR(rango.min_supervivencia == ESCALA_7.nota_minima);
+    VERIFICAR(rango.min_seguridad == ESCALA_7.nota_minima);
+}
+
+CASO(limite_recortado_en_nota_maxima) {
+    // Solo un 7.0 exacto en E2 alcanza el 4.0: 0.5 * 1.0 + 0.5 * 7.0 = 4.0
+    std::vector<Evaluacion> evaluaciones = {
+        { "E1", 0.5, 1.0, {} },
+        { "E2", 0.5, std::nullopt, {} },
+    };
+    comparar_metodos(ESCALA_7, evaluaciones, {});
+
+    EspacioSoluciones espacio = MaquinaS(ESCALA_7).calcular_espacio(evaluaciones, {});
+    VERIFICAR(espacio.rangos_por_evaluacion.at("E2").min_supervivencia == ESCALA_7.nota_maxima);
+}
+
+CASO(cursos_aleatorios) {
+    // Cursos generados con semilla fija: mezcla de tags, reglas y notas conocidas
+    std::mt19937 gen(20240611);
+    const std::vector<std::string> tags = { "a", "b", "c" };
+
+    for (int curso = 0; curso < 400; ++curso) {
+        const Contexto& ctx = curso % 2 == 0 ? ESCALA_7 : ESCALA_100;
+        std::uniform_real_distribution<double> nota(ctx.nota_minima, ctx.nota_maxima);
+        std::uniform_real_distribution<double> unidad(0.0, 1.0);
+
+        int n = 1 + static_cast<int>(gen() % 8);
+        std::vector<Evaluacion> evaluaciones;
+        double suma_pesos = 0.0;
+        for (int i = 0; i < n; ++i) {
+            Evaluacion ev{ "E" + std::to_string(i), 0.05 + unidad(gen), std::nullopt, {} };
+            suma_pesos += ev.peso;
+            if (unidad(gen) < 0.4) ev.valor_actual = nota(gen);
+            for (const auto& tag : tags) {
+                if (unidad(gen) < 0.35) ev.tags.push_back(tag);
+            }
+            evaluaciones.push_back(ev);
+        }
+        for (auto& ev : evaluaciones) ev.peso /= suma_pesos;
+
+        std::vector<Restriccion> restricciones;
+        int n_res = static_cast<int>(gen() % 4);
+        for (int r = 0; r < n_res; ++r) {
+            TipoRestriccion tipo = gen() % 2 == 0 ? TipoRestriccion::PROMEDIO_SIMPLE_TAG
+                                                  : TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG;
+            restricciones.push_back({ "R" + std::to_string(r), tipo, tags[gen() % tags.size()], nota(gen) });
+        }
+
+        comparar_metodos(ctx, evaluaciones, restricciones);
+    }
+}
+
+// ============================================================================
+// HILOS
+// ----------------------------------------------------------------------------
+// Los límites de cada pendiente son independientes y se reparten entre
+// hilos (desde 16 pendientes por hilo); el espacio debe ser idéntico al
+// serial, con los dos métodos.
+// ============================================================================
+
+namespace {
+
+void verificar_igual(const EspacioSoluciones& a, const EspacioSoluciones& b) {
+    VERIFICAR(a.es_posible == b.es_posible);
+    VERIFICAR(a.restricciones_incumplibles == b.restricciones_incumplibles);
+    VERIFICAR(a.rangos_por_evaluacion.size() == b.rangos_por_evaluacion.size());
+    for (const auto& [id, rango] : a.rangos_por_evaluacion) {
+        auto it = b.rangos_por_evaluacion.find(id);
+        VERIFICAR(it != b.rangos_por_evaluacion.end());
+        if (it == b.rangos_por_evaluacion.end()) continue;
+        VERIFICAR(rango.min_supervivencia == it->second.min_supervivencia);
+        VERIFICAR(rango.min_seguridad == it->second.min_seguridad);
+        VERIFICAR(rango.max_posible == it->second.max_posible);
+    }
+}
+
+} // namespace
+
+CASO(hilos_igual_a_serial) {
+    std::mt19937 gen(20250101);
+    const std::vector<std::string> tags = { "a", "b", "c", "d" };
+    int posibles = 0;
+
+    for (int curso = 0; curso < 30; ++curso) {
+        const Contexto& ctx = curso % 2 == 0 ? ESCALA_7 : ESCALA_100;
+        std::uniform_real_distribution<double> nota(ctx.nota_minima, ctx.nota_maxima);
+        std::uniform_real_distribution<double> unidad(0.0, 1.0);
+
+        // Entre 8 y 200 evaluaciones: los chicos quedan seriales
+        const int n = 8 + static_cast<int>(gen() % 193);
+        std::vector<Evaluacion> evaluaciones;
+        double suma_pesos = 0.0;
+        for (int i = 0; i < n; ++i) {
+            Evaluacion ev{ "E" + std::to_string(i), 0.05 + unidad(gen), std::nullopt, {} };
+            suma_pesos += ev.peso;
+            if (unidad(gen) < 0.3) ev.valor_actual = nota(gen);
+            for (const auto& tag : tags) {
+                if (unidad(gen) < 0.3) ev.tags.push_back(tag);
+            }
+            evaluaciones.push_back(ev);
+        }
+        for (auto& ev : evaluaciones) ev.peso /= suma_pesos;
+
+        std::vector<Restriccion> restricciones;
+        const int n_res = static_cast<int>(gen() % 5);
+        for (int r = 0; r < n_res; ++r) {
+            TipoRestriccion tipo = gen() % 2 == 0 ? TipoRestriccion::PROMEDIO_SIMPLE_TAG
+                                                  : TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG;
+            // Mínimos en la mitad baja de la escala para que haya cursos posibles
+            const double minimo = ctx.nota_minima + 0.5 * unidad(gen) * (ctx.nota_maxima - ctx.nota_minima);
+            restricciones.push_back({ "R" + std::to_string(r), tipo, tags[gen() % tags.size()], minimo });
+        }
+
+        for (MetodoLimites metodo : { MetodoLimites::EXACTO, MetodoLimites::BISECCION }) {
+            const EspacioSoluciones serial = MaquinaS(ctx, metodo, 1).calcular_espacio(evaluaciones, restricciones);
+            posibles += serial.es_posible;
+            for (int hilos : { 2, 3, 8, 0 }) {
+                verificar_igual(MaquinaS(ctx, metodo, hilos).calcular_espacio(evaluaciones, restricciones), serial);
+            }
+        }
+    }
+
+    // La prueba solo dice algo si hay rangos que repartir
+    VERIFICAR(posibles > 10);
+}
+
+int main() { return correr_pruebas(); }
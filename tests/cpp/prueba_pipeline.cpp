@@ -0,0 +1,428 @@
+#include "prueba.hpp"
+#include "binario.hpp"
+#include "cache_resultados.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace GradeSolver;
+using json = nlohmann::json;
+
+// ============================================================================
+// CACHE DE RESULTADOS
+// ----------------------------------------------------------------------------
+// Con semilla, la salida memorizada debe ser la misma que resolver desde
+// cero, y la clave no debe depender de cómo se escribió el JSON. Sin
+// semilla la cache no interviene. La expulsión respeta la capacidad en
+// bytes y saca primero la entrada usada hace más tiempo.
+// ============================================================================
+
+namespace {
+
+json entrada_base(json p) {
+    return json{
+        { "contexto", { { "nota_minima", 1.0 }, { "nota_maxima", 7.0 }, { "nota_aprobacion", 4.0 } } },
+        { "evaluaciones", json::array({
+            { { "id", "C1" }, { "peso", 0.3 }, { "valor_actual", 5.0 }, { "tags", json::array({ "c" }) } },
+            { { "id", "C2" }, { "peso", 0.3 }, { "valor_actual", nullptr }, { "tags", json::array({ "c" }) } },
+            { { "id", "Examen" }, { "peso", 0.4 }, { "valor_actual", nullptr }, { "tags", json::array() } },
+        }) },
+        { "restricciones", json::array({
+            { { "id", "Promedio C" }, { "tipo", "PROMEDIO_SIMPLE_TAG" }, { "tag_objetivo", "c" }, { "valor_minimo", 4.0 } },
+        }) },
+        { "P", std::move(p) },
+    };
+}
+
+JSON::EntradaCompleta entrada_con_semilla(uint64_t semilla, int simulaciones = 2000) {
+    return JSON::parse_entrada_completa(entrada_base({ { "simulaciones", simulaciones }, { "semilla", semilla } }));
+}
+
+} // namespace
+
+CASO(clave_canonica_ignora_la_forma_del_json) {
+    VERIFICAR(!clave_canonica(JSON::parse_entrada_completa(entrada_base({ { "simulaciones", 2000 } }))).has_value());
+
+    const auto clave = clave_canonica(entrada_con_semilla(7));
+    VERIFICAR(clave.has_value());
+
+    // Orden de claves, espacios, "7" frente a "7.0" y -0.0 frente a 0.0
+    const auto reescrita = JSON::parse_entrada_completa(json::parse(R"({
+        "P": {"semilla": 7, "simulaciones": 2000},
+        "restricciones": [{"valor_minimo": 4, "tag_objetivo": "c", "tipo": "PROMEDIO_SIMPLE_TAG", "id": "Promedio C"}],
+        "evaluaciones": [
+            {"tags": ["c"], "valor_actual": 5, "peso": 0.3, "id": "C1"},
+            {"tags": ["c"], "valor_actual": null, "peso": 0.3, "id": "C2"},
+            {"tags": [], "valor_actual": null, "peso": 0.4, "id": "Examen"}
+        ],
+        "contexto": {"nota_aprobacion": 4, "nota_maxima": 7, "nota_minima": 1.0}
+    })"));
+    VERIFICAR(clave_canonica(reescrita) == clave);
+
+    json con_cero = entrada_base({ { "simulaciones", 2000 }, { "semilla", 7 } });
+    con_cero["contexto"]["nota_minima"] = 0.0;
+    json con_menos_cero = con_cero;
+    con_menos_cero["contexto"]["nota_minima"] = -0.0;
+    VERIFICAR(clave_canonica(JSON::parse_entrada_completa(con_cero)) ==
+              clave_canonica(JSON::parse_entrada_completa(con_menos_cero)));
+}
+
+CASO(clave_canonica_distingue_lo_que_cambia_el_resultado) {
+    const auto clave = clave_canonica(entrada_con_semilla(7));
+    VERIFICAR(clave_canonica(entrada_con_semilla(8)) != clave);
+    VERIFICAR(clave_canonica(entrada_con_semilla(7, 3000)) != clave);
+
+    // El orden de las evaluaciones fija los flujos aleatorios
+    json invertida = entrada_base({ { "simulaciones", 2000 }, { "semilla", 7 } });
+    std::swap(invertida["evaluaciones"][0], invertida["evaluaciones"][2]);
+    VERIFICAR(clave_canonica(JSON::parse_entrada_completa(invertida)) != clave);
+
+    OpcionesSolver biseccion;
+    biseccion.metodo_limites = MetodoLimites::BISECCION;
+    VERIFICAR(clave_canonica(entrada_con_semilla(7), biseccion) != clave);
+}
+
+CASO(resolver_memorizado_acierta_con_semilla) {
+    CacheResultados cache;
+    const auto entrada = entrada_con_semilla(11);
+
+    const auto primera = resolver_memorizado(entrada, {}, cache);
+    VERIFICAR(*primera == JSON::to_json(resolver(entrada)).dump());
+    VERIFICAR(cache.estadisticas().fallos == 1);
+    VERIFICAR(cache.estadisticas().aciertos == 0);
+    VERIFICAR(cache.estadisticas().entradas == 1);
+
+    // El acierto devuelve la misma cadena guardada, sin copiarla
+    const auto segunda = resolver_memorizado(entrada, {}, cache);
+    VERIFICAR(segunda == primera);
+    VERIFICAR(cache.estadisticas().aciertos == 1);
+
+    // Sin semilla no se busca ni se guarda
+    const auto sin_semilla = JSON::parse_entrada_completa(entrada_base({ { "simulaciones", 500 } }));
+    resolver_memorizado(sin_semilla, {}, cache);
+    const EstadisticasCache e = cache.estadisticas();
+    VERIFICAR(e.omitidas == 1);
+    VERIFICAR(e.fallos == 1 && e.aciertos == 1 && e.entradas == 1);
+
+    cache.limpiar();
+    VERIFICAR(cache.estadisticas().entradas == 0 && cache.estadisticas().bytes == 0);
+    VERIFICAR(resolver_memorizado(entrada, {}, cache) != primera);
+    VERIFICAR(cache.estadisticas().fallos == 2);
+}
+
+CASO(expulsa_la_menos_usada) {
+    const auto valor = [](char c) { return std::make_shared<const std::string>(100, c); };
+
+    // Cada entrada ocupa clave + valor + sobrecarga; caben dos, no tres
+    CacheResultados medida(1u << 20);
+    medida.guardar("a", valor('a'));
+    const size_t por_entrada = medida.estadisticas().bytes;
+
+    CacheResultados cache(2 * por_entrada + por_entrada / 2);
+    cache.guardar("a", valor('a'));
+    cache.guardar("b", valor('b'));
+    VERIFICAR(cache.buscar("a") != nullptr);  // "b" queda como la menos usada
+    cache.guardar("c", valor('c'));
+
+    const EstadisticasCache e = cache.estadisticas();
+    VERIFICAR(e.expulsadas == 1);
+    VERIFICAR(e.entradas == 2);
+    VERIFICAR(e.bytes <= e.capacidad_bytes);
+    VERIFICAR(cache.buscar("b") == nullptr);
+    VERIFICAR(cache.buscar("a") != nullptr);
+    VERIFICAR(cache.buscar("c") != nullptr);
+
+    // Reemplazar una clave no duplica sus bytes
+    cache.guardar("c", valor('x'));
+    VERIFICAR(cache.estadisticas().bytes == 2 * por_entrada);
+    VERIFICAR(*cache.buscar("c") == std::string(100, 'x'));
+
+    // Al achicarla se expulsan las menos usadas; 0 la desactiva
+    cache.configurar_capacidad(por_entrada);
+    VERIFICAR(cache.estadisticas().entradas == 1);
+    VERIFICAR(cache.buscar("c") != nullptr);
+    cache.configurar_capacidad(0);
+    VERIFICAR(cache.estadisticas().entradas == 0);
+    cache.guardar("d", valor('d'));
+    VERIFICAR(cache.buscar("d") == nullptr);
+}
+
+CASO(no_guarda_lo_que_no_cabe) {
+    CacheResultados cache(64);
+    cache.guardar("grande", std::make_shared<const std::string>(1000, 'g'));
+    VERIFICAR(cache.estadisticas().entradas == 0);
+    VERIFICAR(cache.estadisticas().expulsadas == 0);
+}
+
+// ============================================================================
+// ENTRADA/SALIDA BINARIA
+// ----------------------------------------------------------------------------
+// resolver_binario es otra forma de escribir la misma entrada: con la misma
+// semilla cada valor de la salida plana debe ser idéntico al que da
+// resolver sobre el JSON equivalente.
+// ============================================================================
+
+namespace {
+
+struct EntradaBinaria {
+    std::vector<int32_t> enteros;
+    std::vector<double> reales;
+    std::vector<uint8_t> membresia;
+};
+
+// Los tags se numeran en orden de aparición, primero en las evaluaciones
+EntradaBinaria codificar(const JSON::EntradaCompleta& entrada) {
+    std::vector<std::string> tags;
+    const auto indice_tag = [&](const std::string& tag) {
+        auto it = std::find(tags.begin(), tags.end(), tag);
+        if (it == tags.end()) it = tags.insert(tags.end(), tag);
+        return static_cast<int32_t>(it - tags.begin());
+    };
+    for (const auto& eval : entrada.evaluaciones) {
+        for (const auto& tag : eval.tags) indice_tag(tag);
+    }
+    for (const auto& res : entrada.restricciones) indice_tag(res.tag_objetivo);
+
+    const size_t n = entrada.evaluaciones.size();
+    const size_t t = tags.size();
+    const size_t r = entrada.restricciones.size();
+    const uint64_t semilla = entrada.semilla.value_or(0);
+
+    EntradaBinaria b;
+    b.enteros.assign(CABECERA_ENTEROS, 0);
+    b.enteros[ENTERO_EVALUACIONES] = static_cast<int32_t>(n);
+    b.enteros[ENTERO_TAGS] = static_cast<int32_t>(t);
+    b.enteros[ENTERO_RESTRICCIONES] = static_cast<int32_t>(r);
+    b.enteros[ENTERO_SIMULACIONES] = entrada.simulaciones.value_or(0);
+    b.enteros[ENTERO_MUESTREO] = static_cast<int32_t>(entrada.muestreo.value_or(Muestreo::MONTE_CARLO));
+    b.enteros[ENTERO_BANDERAS] = (entrada.semilla ? BANDERA_SEMILLA : 0) | (entrada.perfil ? BANDERA_PERFIL : 0);
+    b.enteros[ENTERO_SEMILLA_BAJA] = static_cast<int32_t>(static_cast<uint32_t>(semilla));
+    b.enteros[ENTERO_SEMILLA_ALTA] = static_cast<int32_t>(static_cast<uint32_t>(semilla >> 32));
+    for (const auto& res : entrada.restricciones) {
+        b.enteros.push_back(static_cast<int32_t>(res.tipo));
+        b.enteros.push_back(indice_tag(res.tag_objetivo));
+    }
+
+    b.reales = { entrada.contexto.nota_minima, entrada.contexto.nota_maxima, entrada.contexto.nota_aprobacion,
+                 entrada.perfil ? entrada.perfil->media_historica : 0.0,
+                 entrada.perfil ? entrada.perfil->desviacion_estandar : 0.0 };
+    for (const auto& eval : entrada.evaluaciones) b.reales.push_back(eval.peso);
+    for (const auto& eval : entrada.evaluaciones) {
+        b.reales.push_back(eval.valor_actual.value_or(std::numeric_limits<double>::quiet_NaN()));
+    }
+    for (const auto& res : entrada.restricciones) b.reales.push_back(res.valor_minimo);
+
+    b.membresia.assign(n * t, 0);
+    for (size_t i = 0; i < n; ++i) {
+        for (const auto& tag : entrada.evaluaciones[i].tags) b.membresia[i * t + indice_tag(tag)] = 1;
+    }
+    return b;
+}
+
+bool mismo_valor(double a, double b) {
+    return (std::isnan(a) && std::isnan(b)) || a == b;
+}
+
+void comparar_con_json(const json& j) {
+    const auto entrada = JSON::parse_entrada_completa(j);
+    const auto esperado = resolver(entrada);
+    const auto binaria = codificar(entrada);
+
+    const size_t n = entrada.evaluaciones.size();
+    const DisposicionSalida disposicion(n, entrada.restricciones.size());
+    VERIFICAR(resolver_binario(binaria.enteros.data(), binaria.reales.data(), binaria.membresia.data(),
+                               nullptr, 0) == disposicion.largo);
+
+    std::vector<double> salida(disposicion.largo);
+    VERIFICAR(resolver_binario(binaria.enteros.data(), binaria.reales.data(), binaria.membresia.data(),
+                               salida.data(), salida.size()) == disposicion.largo);
+
+    const auto& espacio = esperado.espacio_soluciones;
+    VERIFICAR(salida[0] == (espacio.es_posible ? 1.0 : 0.0));
+    for (size_t i = 0; i < n; ++i) {
+        const double* rango = salida.data() + disposicion.rangos + 3 * i;
+        const auto it = espacio.rangos_por_evaluacion.find(entrada.evaluaciones[i].id);
+        if (it == espacio.rangos_por_evaluacion.end()) {
+            VERIFICAR(std::isnan(rango[0]) && std::isnan(rango[1]) && std::isnan(rango[2]));
+            continue;
+        }
+        VERIFICAR(rango[0] == it->second.min_supervivencia);
+        VERIFICAR(rango[1] == it->second.min_seguridad);
+        VERIFICAR(rango[2] == it->second.max_posible);
+    }
+    for (size_t k = 0; k < entrada.restricciones.size(); ++k) {
+        const auto& incumplibles = espacio.restricciones_incumplibles;
+        const bool incumplible =
+            std::find(incumplibles.begin(), incumplibles.end(), entrada.restricciones[k].id) != incumplibles.end();
+        VERIFICAR(salida[disposicion.incumplibles + k] == (incumplible ? 1.0 : 0.0));
+    }
+
+    const auto estrategias = estrategias_registradas();
+    for (size_t p = 0; p < estrategias.size(); ++p) {
+        const double* bloque = salida.data() + disposicion.planes + p * disposicion.por_plan;
+        const auto nombre = JSON::tipo_estrategia_to_string(estrategias[p]);
+        const auto plan = esperado.planes.find(nombre);
+        if (plan == esperado.planes.end()) {
+            for (size_t v = 0; v < disposicion.por_plan; ++v) VERIFICAR(std::isnan(bloque[v]));
+            continue;
+        }
+
+        VERIFICAR(bloque[PLAN_PROMEDIO_TEORICO] == plan->second.promedio_final_teorico);
+        const auto& reporte = esperado.reportes_probabilidad.at(nombre);
+        VERIFICAR(mismo_valor(bloque[PLAN_PROBABILIDAD_GENERAL], reporte.probabilidad_general));
+        VERIFICAR(mismo_valor(bloque[PLAN_PROBABILIDAD_DEL_PLAN], reporte.probabilidad_del_plan));
+        VERIFICAR(mismo_valor(bloque[PLAN_VIABILIDAD], reporte.viabilidad));
+
+        for (size_t i = 0; i < n; ++i) {
+            const auto& eval = entrada.evaluaciones[i];
+            const double nota = eval.valor_actual ? *eval.valor_actual : plan->second.notas_objetivo.at(eval.id);
+            VERIFICAR(bloque[CABECERA_PLAN + i] == nota);
+        }
+    }
+}
+
+} // namespace
+
+CASO(binario_igual_a_json) {
+    comparar_con_json(entrada_base({ { "simulaciones", 3000 }, { "semilla", 5 } }));
+    comparar_con_json(entrada_base({ { "simulaciones", 3000 }, { "semilla", 5 }, { "muestreo", "QMC" } }));
+    comparar_con_json(entrada_base({ { "simulaciones", 3000 }, { "semilla", 5 }, { "muestreo", "IS" },
+                                     { "media_historica", 4.5 }, { "desviacion_estandar", 1.1 } }));
+
+    // Semilla de más de 32 bits: las dos mitades deben llegar enteras
+    comparar_con_json(entrada_base({ { "simulaciones", 1000 }, { "semilla", 0x123456789abcull } }));
+
+    // Tags que se cruzan y una nota mínima por tag
+    json cruzada = entrada_base({ { "simulaciones", 2000 }, { "semilla", 9 } });
+    cruzada["evaluaciones"][2]["tags"] = json::array({ "c", "examen" });
+    cruzada["restricciones"].push_back({ { "id", "Minimo examen" }, { "tipo", "NOTA_MINIMA_INDIVIDUAL_TAG" },
+                                         { "tag_objetivo", "examen" }, { "valor_minimo", 3.5 } });
+    comparar_con_json(cruzada);
+
+    // Curso imposible: sin rangos ni planes, con las restricciones marcadas
+    json imposible = entrada_base({ { "simulaciones", 1000 }, { "semilla", 1 } });
+    imposible["evaluaciones"][0]["valor_actual"] = 1.0;
+    imposible["evaluaciones"][1]["valor_actual"] = 1.0;
+    imposible["restricciones"][0]["valor_minimo"] = 6.5;
+    comparar_con_json(imposible);
+
+    // Imposible solo por el promedio global: ninguna restricción queda marcada
+    json global = entrada_base({ { "simulaciones", 1000 }, { "semilla", 1 } });
+    global["contexto"]["nota_aprobacion"] = 6.5;
+    global["evaluaciones"][0]["valor_actual"] = 1.0;
+    comparar_con_json(global);
+}
+
+CASO(binario_rechaza_entradas_invalidas) {
+    const auto entrada = JSON::parse_entrada_completa(entrada_base({ { "simulaciones", 500 }, { "semilla", 2 } }));
+    const EntradaBinaria valida = codificar(entrada);
+    const size_t n = entrada.evaluaciones.size();
+    const DisposicionSalida disposicion(n, entrada.restricciones.size());
+    std::vector<double> salida(disposicion.largo);
+
+    auto resolver_con = [&](const EntradaBinaria& b) {
+        return resolver_binario(b.enteros.data(), b.reales.data(), b.membresia.data(), salida.data(),
+                                salida.size());
+    };
+    auto rechaza = [&](size_t posicion, double valor) {
+        EntradaBinaria b = valida;
+        b.reales[posicion] = valor;
+        VERIFICAR_LANZA(resolver_con(b), std::runtime_error);
+    };
+    VERIFICAR(resolver_con(valida) == disposicion.largo);
+
+    const double inf = std::numeric_limits<double>::infinity();
+    const size_t pesos = CABECERA_REALES;
+    const size_t notas = pesos + n;
+    const size_t minimos = notas + n;
+
+    // Contexto no finito o invertido
+    rechaza(REAL_NOTA_MINIMA, std::numeric_limits<double>::quiet_NaN());
+    rechaza(REAL_NOTA_MAXIMA, inf);
+    rechaza(REAL_NOTA_MINIMA, 7.0);
+    rechaza(REAL_NOTA_MAXIMA, 0.5);
+    rechaza(REAL_NOTA_APROBACION, 7.5);
+
+    // Pesos negativos o no finitos
+    rechaza(pesos + 1, -0.3);
+    rechaza(pesos + 2, inf);
+    rechaza(pesos, std::numeric_limits<double>::quiet_NaN());
+
+    // Notas fuera de [nota_minima, nota_maxima]; NaN es pendiente
+    rechaza(notas, 7.5);
+    rechaza(notas, 0.0);
+    rechaza(notas, -inf);
+
+    // Mínimo de restricción no finito
+    rechaza(minimos, std::numeric_limits<double>::quiet_NaN());
+
+    // Los bordes de la escala son válidos
+    EntradaBinaria borde = valida;
+    borde.reales[notas] = 7.0;
+    borde.reales[notas + 1] = 1.0;
+    VERIFICAR(resolver_con(borde) == disposicion.largo);
+}
+
+// ============================================================================
+// COHORTES
+// ----------------------------------------------------------------------------
+// Con semilla, la fila e de una cohorte es lo que da `resolver` con las notas
+// de ese estudiante y semilla_estudiante(semilla, e), con cualquier cantidad
+// de hilos. Las pendientes van como NaN en la matriz y como null en la entrada.
+// ============================================================================
+
+namespace {
+
+constexpr double PENDIENTE = std::numeric_limits<double>::quiet_NaN();
+
+// Lo que resolver() devuelve para el estudiante e, en el formato de la cohorte
+json resolver_estudiante(const JSON::EntradaCohorte& cohorte, size_t e) {
+    JSON::EntradaCompleta entrada = cohorte.curso;
+    const size_t n = entrada.evaluaciones.size();
+    for (size_t i = 0; i < n; ++i) {
+        const double nota = cohorte.notas[e * n + i];
+        entrada.evaluaciones[i].valor_actual = std::isnan(nota) ? std::nullopt : std::optional<double>(nota);
+    }
+    entrada.semilla = semilla_estudiante(*cohorte.curso.semilla, e);
+
+    auto salida = resolver(entrada);
+    return JSON::to_json(JSON::ResultadoEstudiante{ std::move(salida.espacio_soluciones), std::move(salida.planes),
+                                                    std::move(salida.reportes_probabilidad),
+                                                    std::move(salida.frontera), salida.perfil_usado });
+}
+
+} // namespace
+
+CASO(cohorte_igual_a_resolver_por_estudiante) {
+    JSON::EntradaCohorte cohorte;
+    cohorte.curso = entrada_con_semilla(31, 3000);
+    cohorte.notas = {
+        5.0, PENDIENTE, PENDIENTE,
+        PENDIENTE, PENDIENTE, PENDIENTE,
+        2.0, 3.0, PENDIENTE,
+        5.0, PENDIENTE, PENDIENTE,  // Mismas notas que el estudiante 0
+        6.0, 5.5, 6.5,              // Sin pendientes
+        1.0, 1.0, PENDIENTE,        // Imposible
+        4.0, PENDIENTE, 3.0,
+    };
+    cohorte.estudiantes = cohorte.notas.size() / cohorte.curso.evaluaciones.size();
+
+    std::vector<json> esperado;
+    for (size_t e = 0; e < cohorte.estudiantes; ++e) esperado.push_back(resolver_estudiante(cohorte, e));
+
+    // Mismas notas, otra semilla: la Máquina P no repite escenarios
+    VERIFICAR(esperado[0]["maquina_s"] == esperado[3]["maquina_s"]);
+    VERIFICAR(esperado[0]["maquina_p"] != esperado[3]["maquina_p"]);
+
+    for (int hilos : { 1, 3, 0 }) {
+        OpcionesSolver opciones;
+        opciones.hilos = hilos;
+        const auto resultados = resolver_cohorte(cohorte, opciones);
+        VERIFICAR(resultados.size() == cohorte.estudiantes);
+        for (size_t e = 0; e < resultados.size(); ++e) {
+            VERIFICAR(JSON::to_json(resultados[e]).dump() == esperado[e].dump());
+        }
+    }
+}
+
+int main() { return correr_pruebas(); }
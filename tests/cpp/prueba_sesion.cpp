@@ -0,0 +1,175 @@
+#include "prueba.hpp"
+#include "sesion.hpp"
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+// ============================================================================
+// SESIÓN INCREMENTAL
+// ----------------------------------------------------------------------------
+// Después de cualquier secuencia de set_grade/clear_grade, la sesión debe
+// responder lo mismo que compilar el curso desde cero con las notas vigentes
+// y pasarlo por las Máquinas S y D.
+// ============================================================================
+
+namespace {
+
+const Contexto ESCALA_7{ 1.0, 7.0, 4.0 };
+const Contexto ESCALA_100{ 0.0, 100.0, 55.0 };
+
+void comparar_con_curso_nuevo(SesionSolver& sesion, const Contexto& ctx,
+                              const std::vector<Evaluacion>& evaluaciones,
+                              const std::vector<Restriccion>& restricciones) {
+    const CursoCompilado curso = compilar_curso(ctx, evaluaciones, restricciones);
+    const EspacioSoluciones esperado = MaquinaS(ctx).calcular_espacio(curso);
+
+    // Consultas sobre los agregados incrementales, antes de recalcular
+    const double tol = 1e-9 * (ctx.nota_maxima - ctx.nota_minima);
+    VERIFICAR(sesion.es_posible() == esperado.es_posible);
+    for (const auto& [id, rango] : esperado.rangos_por_evaluacion) {
+        const RangoFactible incremental = sesion.rango(id);
+        VERIFICAR_CERCA(incremental.min_supervivencia, rango.min_supervivencia, tol);
+        VERIFICAR_CERCA(incremental.min_seguridad, rango.min_seguridad, tol);
+        VERIFICAR(incremental.max_posible == rango.max_posible);
+    }
+
+    // Resultados completos: se recalculan desde cero y deben ser idénticos
+    const EspacioSoluciones& espacio = sesion.espacio();
+    VERIFICAR(espacio.es_posible == esperado.es_posible);
+    VERIFICAR(espacio.restricciones_incumplibles == esperado.restricciones_incumplibles);
+    VERIFICAR(espacio.rangos_por_evaluacion.size() == esperado.rangos_por_evaluacion.size());
+    for (const auto& [id, rango] : esperado.rangos_por_evaluacion) {
+        const RangoFactible& obtenido = espacio.rangos_por_evaluacion.at(id);
+        VERIFICAR(obtenido.min_supervivencia == rango.min_supervivencia);
+        VERIFICAR(obtenido.min_seguridad == rango.min_seguridad);
+        VERIFICAR(obtenido.max_posible == rango.max_posible);
+    }
+
+    if (!esperado.es_posible) return;
+    for (const auto& plan : MaquinaD(ctx).generar_planes(esperado, curso)) {
+        const Sugerencias& obtenido = sesion.sugerencias(plan.estrategia_aplicada.value());
+        VERIFICAR(obtenido.estrategia_aplicada == plan.estrategia_aplicada);
+        VERIFICAR(obtenido.notas_objetivo == plan.notas_objetivo);
+        VERIFICAR(obtenido.promedio_final_teorico == plan.promedio_final_teorico);
+    }
+}
+
+std::vector<Evaluacion> evaluaciones_de_ejemplo() {
+    return {
+        { "Certamen 1", 0.2, std::nullopt, { "certamen" } },
+        { "Certamen 2", 0.3, std::nullopt, { "certamen" } },
+        { "Proyecto", 0.5, std::nullopt, { "proyecto" } },
+    };
+}
+
+std::vector<Restriccion> restricciones_de_ejemplo() {
+    return {
+        { "Promedio de certamenes", TipoRestriccion::PROMEDIO_SIMPLE_TAG, "certamen", 40.0 },
+        { "Minimo del proyecto", TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG, "proyecto", 30.0 },
+    };
+}
+
+} // namespace
+
+CASO(set_grade_rechaza_notas_invalidas) {
+    SesionSolver sesion(ESCALA_100, evaluaciones_de_ejemplo(), restricciones_de_ejemplo());
+
+    VERIFICAR_LANZA(sesion.set_grade("Certamen 1", std::numeric_limits<double>::quiet_NaN()), std::runtime_error);
+    VERIFICAR_LANZA(sesion.set_grade("Certamen 1", std::numeric_limits<double>::infinity()), std::runtime_error);
+    VERIFICAR_LANZA(sesion.set_grade("Certamen 1", -std::numeric_limits<double>::infinity()), std::runtime_error);
+    VERIFICAR_LANZA(sesion.set_grade("Certamen 1", -0.5), std::runtime_error);
+    VERIFICAR_LANZA(sesion.set_grade("Certamen 1", 100.5), std::runtime_error);
+    VERIFICAR_LANZA(sesion.set_grade("No existe", 50.0), std::runtime_error);
+
+    // Una nota rechazada no toca el estado: la evaluación sigue pendiente
+    comparar_con_curso_nuevo(sesion, ESCALA_100, evaluaciones_de_ejemplo(), restricciones_de_ejemplo());
+    VERIFICAR(!sesion.curso().es_conocida(sesion.curso().indice("Certamen 1")));
+
+    // Los extremos de la escala son válidos
+    sesion.set_grade("Certamen 1", 0.0);
+    sesion.set_grade("Certamen 2", 100.0);
+    auto evaluaciones = evaluaciones_de_ejemplo();
+    evaluaciones[0].valor_actual = 0.0;
+    evaluaciones[1].valor_actual = 100.0;
+    comparar_con_curso_nuevo(sesion, ESCALA_100, evaluaciones, restricciones_de_ejemplo());
+}
+
+CASO(sesion_de_ejemplo) {
+    auto evaluaciones = evaluaciones_de_ejemplo();
+    const auto restricciones = restricciones_de_ejemplo();
+    SesionSolver sesion(ESCALA_100, evaluaciones, restricciones);
+    comparar_con_curso_nuevo(sesion, ESCALA_100, evaluaciones, restricciones);
+
+    sesion.set_grade("Certamen 1", 35.0);
+    evaluaciones[0].valor_actual = 35.0;
+    comparar_con_curso_nuevo(sesion, ESCALA_100, evaluaciones, restricciones);
+
+    // Sobrescribir una nota ya puesta
+    sesion.set_grade("Certamen 1", 80.0);
+    evaluaciones[0].valor_actual = 80.0;
+    comparar_con_curso_nuevo(sesion, ESCALA_100, evaluaciones, restricciones);
+
+    sesion.set_grade("Proyecto", 10.0);
+    evaluaciones[2].valor_actual = 10.0;
+    comparar_con_curso_nuevo(sesion, ESCALA_100, evaluaciones, restricciones);
+
+    sesion.clear_grade("Proyecto");
+    evaluaciones[2].valor_actual = std::nullopt;
+    comparar_con_curso_nuevo(sesion, ESCALA_100, evaluaciones, restricciones);
+}
+
+CASO(secuencias_aleatorias) {
+    std::mt19937 gen(4242);
+    const std::vector<std::string> tags = { "a", "b", "c" };
+
+    for (int curso = 0; curso < 150; ++curso) {
+        const Contexto& ctx = curso % 2 == 0 ? ESCALA_7 : ESCALA_100;
+        std::uniform_real_distribution<double> nota(ctx.nota_minima, ctx.nota_maxima);
+        std::uniform_real_distribution<double> unidad(0.0, 1.0);
+
+        int n = 1 + static_cast<int>(gen() % 7);
+        std::vector<Evaluacion> evaluaciones;
+        double suma_pesos = 0.0;
+        for (int i = 0; i < n; ++i) {
+            Evaluacion ev{ "E" + std::to_string(i), 0.05 + unidad(gen), std::nullopt, {} };
+            suma_pesos += ev.peso;
+            if (unidad(gen) < 0.3) ev.valor_actual = nota(gen);
+            for (const auto& tag : tags) {
+                if (unidad(gen) < 0.4) ev.tags.push_back(tag);
+            }
+            evaluaciones.push_back(ev);
+        }
+        for (auto& ev : evaluaciones) ev.peso /= suma_pesos;
+
+        std::vector<Restriccion> restricciones;
+        int n_res = static_cast<int>(gen() % 4);
+        for (int r = 0; r < n_res; ++r) {
+            TipoRestriccion tipo = gen() % 2 == 0 ? TipoRestriccion::PROMEDIO_SIMPLE_TAG
+                                                  : TipoRestriccion::NOTA_MINIMA_INDIVIDUAL_TAG;
+            restricciones.push_back({ "R" + std::to_string(r), tipo, tags[gen() % tags.size()],
+                                      ctx.nota_minima + 0.6 * (nota(gen) - ctx.nota_minima) });
+        }
+
+        SesionSolver sesion(ctx, evaluaciones, restricciones);
+        comparar_con_curso_nuevo(sesion, ctx, evaluaciones, restricciones);
+
+        // Varias pulsaciones seguidas entre consultas, para acumular sumas y restas
+        for (int paso = 0; paso < 12; ++paso) {
+            const int cambios = 1 + static_cast<int>(gen() % 3);
+            for (int c = 0; c < cambios; ++c) {
+                Evaluacion& ev = evaluaciones[gen() % evaluaciones.size()];
+                if (unidad(gen) < 0.25) {
+                    sesion.clear_grade(ev.id);
+                    ev.valor_actual = std::nullopt;
+                } else {
+                    const double valor = nota(gen);
+                    sesion.set_grade(ev.id, valor);
+                    ev.valor_actual = valor;
+                }
+            }
+            comparar_con_curso_nuevo(sesion, ctx, evaluaciones, restricciones);
+        }
+    }
+}
+
+int main() { return correr_pruebas(); }
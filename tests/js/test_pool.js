@@ -0,0 +1,196 @@
+#!/usr/bin/env node
+
+// Pruebas de binding/js/pool.js sin WASM: pool.js se copia a un directorio
+// temporal junto a un index.js y un pool_worker.js falsos. El worker falso
+// responde lo que se le pide (esperar, fallar, caerse) y así se prueban el
+// reparto, la cola, los errores y el reemplazo de workers.
+
+const assert = require('assert');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const colors = {
+    reset: '\x1b[0m',
+    green: '\x1b[32m',
+    red: '\x1b[31m',
+};
+
+function log(color, message) {
+    console.log(color + message + colors.reset);
+}
+
+const INDEX_FALSO = `
+module.exports.compileWasm = () => Promise.resolve({ falso: true });
+`;
+
+// Entrada: { valor, esperaMs, falla, caida }. Responde antes de recibir el
+// módulo compilado solo si algo anda mal en pool.js.
+const WORKER_FALSO = `
+const { parentPort, threadId } = require('worker_threads');
+let wasm = null;
+let activas = 0;
+parentPort.on('message', ({ id, op, input, wasm: recibido }) => {
+    if (op === 'wasm') {
+        wasm = recibido;
+        return;
+    }
+    if (wasm === null) {
+        parentPort.postMessage({ id, ok: false, error: 'tarea antes del wasm' });
+        return;
+    }
+    if (input.caida) {
+        process.exit(3);
+    }
+    activas++;
+    setTimeout(() => {
+        activas--;
+        if (input.falla) {
+            parentPort.postMessage({ id, ok: false, error: 'fallo pedido: ' + input.valor });
+        } else {
+            parentPort.postMessage({ id, ok: true, result: { op, valor: input.valor, hilo: threadId, activas } });
+        }
+    }, input.esperaMs ?? 0);
+});
+`;
+
+function cargarPool() {
+    const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'gradesolver-pool-'));
+    fs.copyFileSync(path.join(__dirname, '../../binding/js/pool.js'), path.join(dir, 'pool.js'));
+    fs.writeFileSync(path.join(dir, 'index.js'), INDEX_FALSO);
+    fs.writeFileSync(path.join(dir, 'pool_worker.js'), WORKER_FALSO);
+    return { createPool: require(path.join(dir, 'pool.js')), dir };
+}
+
+const { createPool, dir } = cargarPool();
+const pruebas = [];
+
+function prueba(nombre, fn) {
+    pruebas.push({ nombre, fn });
+}
+
+// Arrancar un worker toma un tiempo que depende de la máquina
+async function esperarHasta(condicion) {
+    const limite = Date.now() + 5000;
+    while (!condicion()) {
+        assert.ok(Date.now() < limite, 'tiempo de espera agotado');
+        await new Promise((resolve) => setTimeout(resolve, 1));
+    }
+}
+
+prueba('reparte las tareas y devuelve cada resultado a quien lo pidio', async () => {
+    const pool = createPool({ size: 3 });
+    try {
+        const tareas = Array.from({ length: 30 }, (_, i) => pool.solve({ valor: i, esperaMs: i % 4 }));
+        const resultados = await Promise.all(tareas);
+
+        resultados.forEach((r, i) => {
+            assert.strictEqual(r.valor, i);
+            assert.strictEqual(r.op, 'solve');
+            assert.strictEqual(r.activas, 0);  // Un worker atiende una tarea a la vez
+        });
+        assert.strictEqual(new Set(resultados.map((r) => r.hilo)).size, 3);
+
+        const lote = await pool.solveBatch({ valor: 'lote' });
+        assert.strictEqual(lote.op, 'solveBatch');
+
+        const stats = pool.stats();
+        assert.strictEqual(stats.workers, 3);
+        assert.strictEqual(stats.completadas, 31);
+        assert.strictEqual(stats.fallidas, 0);
+        assert.strictEqual(stats.ocupados, 0);
+        assert.strictEqual(stats.enCola, 0);
+        assert.ok(stats.latenciaMs.p50 <= stats.latenciaMs.p99);
+        assert.ok(stats.latenciaMs.p99 <= stats.latenciaMs.max);
+    } finally {
+        await pool.close();
+    }
+});
+
+prueba('un error del worker rechaza solo su tarea', async () => {
+    const pool = createPool({ size: 2 });
+    try {
+        const resultados = await Promise.allSettled([
+            pool.solve({ valor: 1 }),
+            pool.solve({ valor: 2, falla: true }),
+            pool.solve({ valor: 3 }),
+        ]);
+        assert.strictEqual(resultados[0].value.valor, 1);
+        assert.strictEqual(resultados[1].status, 'rejected');
+        assert.strictEqual(resultados[1].reason.message, 'fallo pedido: 2');
+        assert.strictEqual(resultados[2].value.valor, 3);
+
+        const stats = pool.stats();
+        assert.strictEqual(stats.completadas, 2);
+        assert.strictEqual(stats.fallidas, 1);
+    } finally {
+        await pool.close();
+    }
+});
+
+prueba('con la cola llena rechaza de inmediato', async () => {
+    const pool = createPool({ size: 1, maxQueue: 2 });
+    try {
+        // Ningún worker está libre hasta que llegue el módulo compilado
+        const aceptadas = [pool.solve({ valor: 1, esperaMs: 20 }), pool.solve({ valor: 2 })];
+        await assert.rejects(pool.solve({ valor: 3 }), (error) => error.code === 'GRADESOLVER_POOL_LLENO');
+        assert.strictEqual(pool.stats().rechazadas, 1);
+
+        const resultados = await Promise.all(aceptadas);
+        assert.deepStrictEqual(resultados.map((r) => r.valor), [1, 2]);
+        assert.strictEqual((await pool.solve({ valor: 4 })).valor, 4);
+    } finally {
+        await pool.close();
+    }
+});
+
+prueba('un worker caido rechaza su tarea y se reemplaza', async () => {
+    const pool = createPool({ size: 2 });
+    try {
+        const antes = await Promise.all([pool.solve({ valor: 'a', esperaMs: 5 }), pool.solve({ valor: 'b', esperaMs: 5 })]);
+        const hilosAntes = new Set(antes.map((r) => r.hilo));
+
+        await assert.rejects(pool.solve({ valor: 'x', caida: true }), /codigo 3/);
+        assert.strictEqual(pool.stats().workers, 2);
+
+        const despues = await Promise.all(Array.from({ length: 8 }, (_, i) => pool.solve({ valor: i, esperaMs: 25 })));
+        despues.forEach((r, i) => assert.strictEqual(r.valor, i));
+        // Las tareas duran lo suficiente para que el reemplazo alcance a tomar alguna
+        assert.ok(despues.some((r) => !hilosAntes.has(r.hilo)));
+        assert.strictEqual(pool.stats().fallidas, 1);
+    } finally {
+        await pool.close();
+    }
+});
+
+prueba('close rechaza lo pendiente y las llamadas posteriores', async () => {
+    const pool = createPool({ size: 1 });
+    // Los rechazos se esperan desde antes de cerrar para no quedar sin manejar
+    const enCurso = assert.rejects(pool.solve({ valor: 1, esperaMs: 50 }), /cerrado/);
+    const enCola = assert.rejects(pool.solve({ valor: 2 }), /cerrado/);
+    await esperarHasta(() => pool.stats().ocupados === 1);
+    assert.strictEqual(pool.stats().enCola, 1);
+
+    await pool.close();
+    await Promise.all([enCurso, enCola]);
+    await assert.rejects(pool.solve({ valor: 3 }), /cerrado/);
+    assert.strictEqual(pool.stats().workers, 0);
+});
+
+async function correr() {
+    let fallidas = 0;
+    for (const { nombre, fn } of pruebas) {
+        try {
+            await fn();
+            log(colors.green, `✓ ${nombre}`);
+        } catch (error) {
+            fallidas++;
+            log(colors.red, `✗ ${nombre}\n  ${error.stack}`);
+        }
+    }
+    fs.rmSync(dir, { recursive: true, force: true });
+    console.log(`\n${pruebas.length} pruebas, ${fallidas} fallidas`);
+    process.exit(fallidas === 0 ? 0 : 1);
+}
+
+correr();